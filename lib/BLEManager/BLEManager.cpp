@@ -1,50 +1,290 @@
 #include "BLEManager.h"
 
-void BLEManager::ServerCallbacks::onConnect(BLEServer* pServer) {
-  *connectedFlag = true;
+#include <stddef.h>
+
+#include <algorithm>
+
+BLEManager* BLEManager::instance = nullptr;
+
+void BLEManager::ServerCallbacks::onConnect(
+    BLEServer* pServer, esp_ble_gatts_cb_param_t* param
+) {
+  manager->mtu = 23;  // Até a troca de MTU pedida pelo cliente
+  manager->congested = false;
+  manager->deviceConnected = true;
   Serial.println("BLE Client Connected");
+
+  // Intervalo curto para vazão; o cliente pode recusar ou ajustar
+  pServer->updateConnParams(
+      param->connect.remote_bda,
+      BLE_MIN_CONN_INTERVAL,
+      BLE_MAX_CONN_INTERVAL,
+      0,
+      BLE_SUPERVISION_TIMEOUT
+  );
+}
+
+void BLEManager::ServerCallbacks::onMtuChanged(
+    BLEServer* pServer, esp_ble_gatts_cb_param_t* param
+) {
+  manager->mtu = param->mtu.mtu;
+  Serial.printf(
+      "BLE MTU set to %u (%u packets per notification)\n",
+      param->mtu.mtu,
+      (unsigned) manager->maxPacketsPerNotification()
+  );
 }
 
 void BLEManager::ServerCallbacks::onDisconnect(BLEServer* pServer) {
-  *connectedFlag = false;
+  manager->deviceConnected = false;
+  manager->congested = false;
   Serial.println("BLE Client Disconnected");
   pServer->getAdvertising()->start();
 }
 
+void BLEManager::NotifyCallbacks::onStatus(
+    BLECharacteristic* pCharacteristic, Status s, uint32_t code
+) {
+  // Cliente não inscrito nesta característica: não é falha de envio
+  if (s == ERROR_NOTIFY_DISABLED || s == ERROR_INDICATE_DISABLED) {
+    manager->notifyDisabled = true;
+    return;
+  }
+  if (s != SUCCESS_NOTIFY && s != SUCCESS_INDICATE) {
+    manager->notifyFailures++;
+  }
+}
+
+void BLEManager::gattsEventHandler(
+    esp_gatts_cb_event_t event,
+    esp_gatt_if_t gattsIf,
+    esp_ble_gatts_cb_param_t* param
+) {
+  if (event == ESP_GATTS_CONGEST_EVT && instance != nullptr) {
+    instance->congested = param->congest.congested;
+    if (param->congest.congested) {
+      instance->congestionEvents++;
+    }
+  }
+}
+
+void BLEManager::ControlCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+  std::string value = pCharacteristic->getValue();
+  if (*queue == NULL || value.empty()) {
+    return;
+  }
+
+  // Bytes ausentes valem zero (ex.: só o modo para voltar à varredura)
+  MonitorCommand command = {};
+  memcpy(
+      &command, value.data(), std::min(value.size(), sizeof(MonitorCommand))
+  );
+  if (command.num_points > MAX_MONITOR_POINTS) {
+    command.num_points = MAX_MONITOR_POINTS;
+  }
+  xQueueOverwrite(*queue, &command);
+}
+
 BLEManager::BLEManager(const std::string& deviceName)
     : pCharacteristic(nullptr),
+      pClassificationCharacteristic(nullptr),
+      pMonitorCharacteristic(nullptr),
+      pControlCharacteristic(nullptr),
+      pCompensatedCharacteristic(nullptr),
+      pLinkStatsCharacteristic(nullptr),
       deviceConnected(false),
-      deviceName(deviceName) { }
+      deviceName(deviceName),
+      commandQueue(NULL),
+      congested(false),
+      mtu(23),
+      notifyDisabled(false),
+      notifyFailures(0),
+      notifications(0),
+      bytesSent(0),
+      droppedPackets(0),
+      congestionEvents(0),
+      lastStatsBytes(0),
+      lastStatsMs(0) { }
 
 void BLEManager::init() {
+  instance = this;
   BLEDevice::init(deviceName);
+  BLEDevice::setMTU(BLE_PREFERRED_MTU);
+  BLEDevice::setCustomGattsHandler(gattsEventHandler);
 
   BLEServer* pServer = BLEDevice::createServer();
-  pServer->setCallbacks(new ServerCallbacks(&deviceConnected));
+  pServer->setCallbacks(new ServerCallbacks(this));
+  NotifyCallbacks* notifyCallbacks = new NotifyCallbacks(this);
 
-  BLEService* pService = pServer->createService(SERVICE_UUID);
+  BLEService* pService =
+      pServer->createService(BLEUUID(SERVICE_UUID), SERVICE_NUM_HANDLES);
 
   pCharacteristic = pService->createCharacteristic(
       CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_NOTIFY
   );
 
   pCharacteristic->addDescriptor(new BLE2902());
+  pCharacteristic->setCallbacks(notifyCallbacks);
+
+  pClassificationCharacteristic = pService->createCharacteristic(
+      CLASSIFICATION_CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_NOTIFY
+  );
+
+  pClassificationCharacteristic->addDescriptor(new BLE2902());
+  pClassificationCharacteristic->setCallbacks(notifyCallbacks);
+
+  pMonitorCharacteristic = pService->createCharacteristic(
+      MONITOR_CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_NOTIFY
+  );
+
+  pMonitorCharacteristic->addDescriptor(new BLE2902());
+  pMonitorCharacteristic->setCallbacks(notifyCallbacks);
+
+  pControlCharacteristic = pService->createCharacteristic(
+      CONTROL_CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_WRITE
+  );
+
+  pControlCharacteristic->setCallbacks(new ControlCallbacks(&commandQueue));
+
+  pCompensatedCharacteristic = pService->createCharacteristic(
+      COMPENSATED_CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_NOTIFY
+  );
+
+  pCompensatedCharacteristic->addDescriptor(new BLE2902());
+  pCompensatedCharacteristic->setCallbacks(notifyCallbacks);
+
+  pLinkStatsCharacteristic = pService->createCharacteristic(
+      LINK_STATS_CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_READ
+  );
 
   pService->start();
 
   BLEAdvertising* pAdvertising = BLEDevice::getAdvertising();
   pAdvertising->addServiceUUID(SERVICE_UUID);
   pAdvertising->setScanResponse(true);
-  pAdvertising->setMinPreferred(0x06);
-  pAdvertising->setMinPreferred(0x12);
+  pAdvertising->setMinPreferred(BLE_MIN_CONN_INTERVAL);
+  pAdvertising->setMaxPreferred(BLE_MAX_CONN_INTERVAL);
   BLEDevice::startAdvertising();
 
   Serial.println("Waiting for a client connection to notify...");
 }
 
-void BLEManager::sendData(const DataPacket& packet) {
-  if (deviceConnected && pCharacteristic != nullptr) {
-    pCharacteristic->setValue((uint8_t*) &packet, sizeof(DataPacket));
-    pCharacteristic->notify();
+bool BLEManager::notify(
+    BLECharacteristic* characteristic,
+    const uint8_t* data,
+    size_t size,
+    size_t packets
+) {
+  if (!deviceConnected || characteristic == nullptr) {
+    return false;
+  }
+
+  // A pilha truncaria a notificação no MTU, e o cliente descartaria o resto
+  if (size > (size_t) mtu - 3) {
+    droppedPackets += packets;
+    return false;
+  }
+
+  // Aguarda a pilha esvaziar seus buffers antes de desistir
+  unsigned long start = millis();
+  while (congested && deviceConnected &&
+         millis() - start < BLE_CONGESTION_WAIT_MS) {
+    vTaskDelay(1);
+  }
+  if (congested) {
+    droppedPackets += packets;
+    return false;
+  }
+
+  // notify() chama onStatus antes de retornar
+  uint32_t failuresBefore = notifyFailures;
+  notifyDisabled = false;
+  characteristic->setValue((uint8_t*) data, size);
+  characteristic->notify();
+  if (notifyDisabled) {
+    return false;
+  }
+  if (notifyFailures != failuresBefore) {
+    droppedPackets += packets;
+    return false;
+  }
+
+  notifications++;
+  bytesSent += size;
+  return true;
+}
+
+size_t BLEManager::maxPacketsPerNotification() const {
+  size_t perNotification = ((size_t) mtu - 3) / sizeof(DataPacket);
+  return perNotification > 0 ? perNotification : 1;
+}
+
+bool BLEManager::sendData(const DataPacket& packet) {
+  return sendData(&packet, 1) == 1;
+}
+
+size_t BLEManager::sendData(const DataPacket* packets, size_t count) {
+  size_t accepted = 0;
+  size_t perNotification = maxPacketsPerNotification();
+  // Pacotes recusados já foram contados como descartados em notify()
+  for (size_t i = 0; i < count && deviceConnected; i += perNotification) {
+    size_t n = std::min(perNotification, count - i);
+    if (notify(
+            pCharacteristic,
+            (const uint8_t*) &packets[i],
+            n * sizeof(DataPacket),
+            n
+        )) {
+      accepted += n;
+    }
+  }
+  return accepted;
+}
+
+bool BLEManager::sendClassification(const OdorClassification& classification) {
+  return notify(
+      pClassificationCharacteristic,
+      (const uint8_t*) &classification,
+      sizeof(OdorClassification)
+  );
+}
+
+bool BLEManager::sendMonitorBatch(const MonitorBatch& batch) {
+  size_t size =
+      offsetof(MonitorBatch, samples) + batch.count * sizeof(MonitorSample);
+  return notify(pMonitorCharacteristic, (const uint8_t*) &batch, size);
+}
+
+bool BLEManager::sendCompensatedFeatures(const CompensatedFeatures& features) {
+  return notify(
+      pCompensatedCharacteristic,
+      (const uint8_t*) &features,
+      sizeof(CompensatedFeatures)
+  );
+}
+
+void BLEManager::setCommandQueue(QueueHandle_t queue) { commandQueue = queue; }
+
+BLELinkStats BLEManager::getLinkStats() {
+  unsigned long now = millis();
+  BLELinkStats stats;
+  stats.mtu = mtu;
+  stats.connected = deviceConnected;
+  stats.congested = congested;
+  stats.notifications = notifications;
+  stats.bytes_sent = bytesSent;
+  stats.notify_failures = notifyFailures;
+  stats.dropped_packets = droppedPackets;
+  stats.congestion_events = congestionEvents;
+  stats.bytes_per_second =
+      now > lastStatsMs
+          ? (bytesSent - lastStatsBytes) * 1000.0f / (now - lastStatsMs)
+          : 0.0f;
+  lastStatsBytes = bytesSent;
+  lastStatsMs = now;
+
+  if (pLinkStatsCharacteristic != nullptr) {
+    pLinkStatsCharacteristic->setValue((uint8_t*) &stats, sizeof(stats));
   }
+  return stats;
 }
@@ -7,10 +7,48 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 
+#include "PacketTransport.h"
 #include "SensorData.h"
 
 #define SERVICE_UUID "bea5692f-939d-4e5a-bfa9-80d3efb8e3cb"
 #define CHARACTERISTIC_UUID "b13493c7-5499-4b0a-a3d9-66eea53f382c"
+#define CLASSIFICATION_CHARACTERISTIC_UUID \
+  "5c1e0a7d-2f43-4b8e-9d61-3a7f0e9b2c14"
+#define MONITOR_CHARACTERISTIC_UUID "8d2b6f41-7c3e-4a90-b5d8-1e6f2a9c0b37"
+#define CONTROL_CHARACTERISTIC_UUID "e4a7c2d9-5b18-4f63-a0e2-9c7d3b8f1a56"
+#define COMPENSATED_CHARACTERISTIC_UUID \
+  "3f9a1c6e-84d2-4b57-a1e3-6c0d8b2f7e95"
+#define LINK_STATS_CHARACTERISTIC_UUID "a6d0e5b3-19c4-4f7a-8e25-b7c1d93f4a08"
+
+// Handles do serviço: 1 para o serviço, 3 por característica com
+// notificação (declaração, valor, CCCD) e 2 por característica de escrita
+#define SERVICE_NUM_HANDLES 32
+
+// --- Parâmetros do enlace pedidos ao cliente ---
+#define BLE_PREFERRED_MTU 517        // Maior MTU do ATT (512 de dados)
+#define BLE_MIN_CONN_INTERVAL 6      // 7,5 ms (unidades de 1,25 ms)
+#define BLE_MAX_CONN_INTERVAL 12     // 15 ms
+#define BLE_SUPERVISION_TIMEOUT 400  // 4 s (unidades de 10 ms)
+#define BLE_CONGESTION_WAIT_MS 100   // Espera máxima antes de descartar
+
+/**
+ * @struct BLELinkStats
+ * @brief Link state and counters since boot. Readable by the client on the
+ * link stats characteristic.
+ */
+#pragma pack(push, 1)
+struct BLELinkStats {
+  uint16_t mtu;                // MTU negociado (23 até a troca de MTU)
+  uint8_t connected;
+  uint8_t congested;
+  uint32_t notifications;      // Notificações aceitas pela pilha
+  uint32_t bytes_sent;
+  uint32_t notify_failures;    // Erros informados em onStatus
+  uint32_t dropped_packets;    // Pacotes descartados com cliente conectado
+  uint32_t congestion_events;
+  float bytes_per_second;      // Vazão desde a leitura anterior
+};
+#pragma pack(pop)
 
 /**
  * @class BLEManager
@@ -18,8 +56,13 @@
  *
  * This class encapsulates the setup of the BLE server, service, and
  * characteristic, as well as handling connections and sending data.
+ *
+ * On connect it asks for a large MTU and a short connection interval, and
+ * it tracks the negotiated MTU, stack congestion and notify failures, so
+ * that several DataPackets can share one notification and a congested link
+ * drops packets visibly instead of silently.
  */
-class BLEManager {
+class BLEManager : public PacketTransport {
  public:
   /**
    * @brief Construct a new BLEManager object.
@@ -38,13 +81,136 @@ class BLEManager {
    * @brief Sends a DataPacket over BLE if a client is connected.
    *
    * @param packet The DataPacket to be sent.
+   * @return true if the notification was accepted by the stack.
+   */
+  bool sendData(const DataPacket& packet);
+
+  /**
+   * @brief Sends several DataPackets, packing as many as the negotiated MTU
+   * allows into each notification.
+   *
+   * @param packets The packets to be sent, in order.
+   * @param count Number of packets.
+   * @return Number of packets accepted by the stack.
    */
-  void sendData(const DataPacket& packet);
+  size_t sendData(const DataPacket* packets, size_t count) override;
+
+  /**
+   * @brief Gets how many DataPackets fit in one notification at the
+   * current MTU (at least 1).
+   */
+  size_t maxPacketsPerNotification() const;
+
+  /**
+   * @brief Sends the classifier output over BLE if a client is connected.
+   *
+   * @param classification The result of the on-device classifier.
+   * @return true if the notification was accepted by the stack.
+   */
+  bool sendClassification(const OdorClassification& classification) override;
+
+  /**
+   * @brief Sends a batch of monitoring samples in a single notification.
+   * Only the `count` valid samples are transmitted.
+   *
+   * @param batch The batch to be sent.
+   * @return true if the notification was accepted by the stack.
+   */
+  bool sendMonitorBatch(const MonitorBatch& batch) override;
+
+  /**
+   * @brief Sends the drift-corrected features of a measurement cycle.
+   *
+   * @param features The features to be sent.
+   * @return true if the notification was accepted by the stack.
+   */
+  bool sendCompensatedFeatures(const CompensatedFeatures& features) override;
+
+  /**
+   * @brief Raw sample blocks do not fit in a notification and would starve
+   * the other characteristics; they are only sent over the serial link.
+   *
+   * @return Always false.
+   */
+  bool sendRawSamples(const RawSampleBlock& block) override { return false; }
+
+  /**
+   * @brief Sets the queue that receives MonitorCommands written by the
+   * client. The queue must hold MonitorCommand items; the latest command
+   * overwrites any unread one, so a length of 1 is enough.
+   *
+   * @param queue The FreeRTOS queue, or NULL to ignore commands.
+   */
+  void setCommandQueue(QueueHandle_t queue);
+
+  /**
+   * @brief Gets the link counters and the throughput since the previous
+   * call, and publishes them on the link stats characteristic.
+   */
+  BLELinkStats getLinkStats();
+
+  /**
+   * @brief Checks whether a client is connected.
+   */
+  bool isConnected() const override { return deviceConnected; }
 
  private:
   BLECharacteristic* pCharacteristic;
-  bool deviceConnected;
+  BLECharacteristic* pClassificationCharacteristic;
+  BLECharacteristic* pMonitorCharacteristic;
+  BLECharacteristic* pControlCharacteristic;
+  BLECharacteristic* pCompensatedCharacteristic;
+  BLECharacteristic* pLinkStatsCharacteristic;
+  volatile bool deviceConnected;
   std::string deviceName;
+  QueueHandle_t commandQueue;
+
+  // Estado da conexão atual (atualizado pelas callbacks da pilha BLE)
+  volatile bool congested;
+  volatile uint16_t mtu;
+  // Última notify() recusada por falta de inscrição do cliente
+  volatile bool notifyDisabled;
+
+  // Contadores do enlace
+  volatile uint32_t notifyFailures;
+  uint32_t notifications;
+  uint32_t bytesSent;
+  uint32_t droppedPackets;
+  volatile uint32_t congestionEvents;
+  uint32_t lastStatsBytes;
+  unsigned long lastStatsMs;
+
+  /**
+   * @brief Instance reached by the GATT server event handler, which is a
+   * plain function.
+   */
+  static BLEManager* instance;
+
+  /**
+   * @brief Sends one notification, waiting out congestion for at most
+   * BLE_CONGESTION_WAIT_MS.
+   *
+   * @param characteristic The characteristic to notify.
+   * @param data The payload.
+   * @param size The payload size in bytes.
+   * @param packets Number of packets in the payload, for the drop counter.
+   * @return true if the notification was accepted by the stack.
+   */
+  bool notify(
+      BLECharacteristic* characteristic,
+      const uint8_t* data,
+      size_t size,
+      size_t packets = 1
+  );
+
+  /**
+   * @brief Tracks the congestion events of the GATT server.
+   */
+  static void gattsEventHandler(
+      esp_gatts_cb_event_t event,
+      esp_gatt_if_t gattsIf,
+      esp_ble_gatts_cb_param_t* param
+  );
 
   /**
    * @class ServerCallbacks
@@ -53,21 +219,32 @@ class BLEManager {
   class ServerCallbacks : public BLEServerCallbacks {
    public:
     /**
-     * @brief Pointer to the parent BLEManager's connection status flag.
+     * @brief Pointer to the parent BLEManager.
      */
-    bool* connectedFlag;
+    BLEManager* manager;
 
     /**
      * @brief Construct a new ServerCallbacks object.
-     * @param flag Pointer to the boolean flag indicating connection status.
+     * @param manager Pointer to the parent BLEManager.
      */
-    ServerCallbacks(bool* flag) : connectedFlag(flag) { }
+    ServerCallbacks(BLEManager* manager) : manager(manager) { }
 
     /**
-     * @brief Called when a BLE client connects.
+     * @brief Called when a BLE client connects. Requests the preferred
+     * connection parameters.
      * @param pServer A pointer to the BLE server instance.
+     * @param param The connection event parameters.
      */
-    void onConnect(BLEServer* pServer) override;
+    void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param)
+        override;
+
+    /**
+     * @brief Called when the client and the server agree on a new MTU.
+     * @param pServer A pointer to the BLE server instance.
+     * @param param The MTU event parameters.
+     */
+    void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param)
+        override;
 
     /**
      * @brief Called when a BLE client disconnects.
@@ -75,6 +252,58 @@ class BLEManager {
      */
     void onDisconnect(BLEServer* pServer) override;
   };
+
+  /**
+   * @class ControlCallbacks
+   * @brief Forwards commands written to the control characteristic to the
+   * acquisition task.
+   */
+  class ControlCallbacks : public BLECharacteristicCallbacks {
+   public:
+    /**
+     * @brief Pointer to the parent BLEManager's command queue handle.
+     */
+    QueueHandle_t* queue;
+
+    /**
+     * @brief Construct a new ControlCallbacks object.
+     * @param queue Pointer to the command queue handle.
+     */
+    ControlCallbacks(QueueHandle_t* queue) : queue(queue) { }
+
+    /**
+     * @brief Called when the client writes to the control characteristic.
+     * @param pCharacteristic The written characteristic.
+     */
+    void onWrite(BLECharacteristic* pCharacteristic) override;
+  };
+
+  /**
+   * @class NotifyCallbacks
+   * @brief Counts the notify failures reported by the stack.
+   */
+  class NotifyCallbacks : public BLECharacteristicCallbacks {
+   public:
+    /**
+     * @brief Pointer to the parent BLEManager.
+     */
+    BLEManager* manager;
+
+    /**
+     * @brief Construct a new NotifyCallbacks object.
+     * @param manager Pointer to the parent BLEManager.
+     */
+    NotifyCallbacks(BLEManager* manager) : manager(manager) { }
+
+    /**
+     * @brief Called after each notify() with its outcome.
+     * @param pCharacteristic The notified characteristic.
+     * @param s The outcome.
+     * @param code The stack error code, if any.
+     */
+    void onStatus(BLECharacteristic* pCharacteristic, Status s, uint32_t code)
+        override;
+  };
 };
 
 #endif  // BLE_MANAGER_H
@@ -0,0 +1,92 @@
+#include "CycleScheduler.h"
+
+namespace {
+
+// Folga somada a um warm-up maior que a estimativa
+const uint32_t WARM_UP_MARGIN_US = 500;
+
+}  // namespace
+
+CycleScheduler::CycleScheduler(
+    SchedulerPlatform& platform, const SchedulerConfig& config
+)
+    : platform(platform), config(config), warmUpUs(config.initialWarmUpUs) { }
+
+uint64_t CycleScheduler::beginCycle() {
+  uint64_t now = platform.nowUs();
+  if (!planned || now <= nextDeadlineUs) {
+    // Primeiro ciclo, ou início antecipado por um comando: planeja a partir
+    // de agora
+    plannedStartUs = now;
+    planned = true;
+  } else {
+    // Atrasado: mantém a fase do plano para não acumular o atraso
+    plannedStartUs = nextDeadlineUs;
+    uint64_t lateness = now - nextDeadlineUs;
+    if (lateness > counters.maxLatenessUs) {
+      counters.maxLatenessUs = static_cast<uint32_t>(lateness);
+    }
+    if (lateness > config.deadlineToleranceUs) {
+      counters.missedDeadlines++;
+    }
+  }
+  cycleStartUs = now;
+  return now;
+}
+
+bool CycleScheduler::waitForNextCycle() {
+  uint64_t now = platform.nowUs();
+  counters.workUs += now - cycleStartUs;
+  counters.cycles++;
+
+  uint64_t next = plannedStartUs + config.periodUs;
+  if (now >= next) {
+    counters.overruns++;
+    nextDeadlineUs = now;
+    return true;
+  }
+  nextDeadlineUs = next;
+
+  if (next - now >= (uint64_t) config.minLowPowerUs + warmUpUs) {
+    uint64_t wakeAt = next - warmUpUs;
+    platform.powerDownPeripherals();
+    bool completed = platform.idleUntilUs(wakeAt, true);
+    uint64_t awake = platform.nowUs();
+    counters.lowPowerUs += awake - now;
+
+    platform.powerUpPeripherals();
+    uint64_t ready = platform.nowUs();
+    counters.warmUpUs += ready - awake;
+    if (!completed) {
+      counters.interruptions++;
+      return false;
+    }
+
+    // Warm-up medido: atraso do despertar mais o religamento
+    uint64_t warmUpStart = awake > wakeAt ? wakeAt : awake;
+    updateWarmUp(static_cast<uint32_t>(ready - warmUpStart));
+    now = ready;
+  }
+
+  if (now < next) {
+    bool completed = platform.idleUntilUs(next, false);
+    counters.idleUs += platform.nowUs() - now;
+    if (!completed) {
+      counters.interruptions++;
+      return false;
+    }
+  }
+  return true;
+}
+
+void CycleScheduler::resync() { planned = false; }
+
+void CycleScheduler::updateWarmUp(uint32_t measuredUs) {
+  if (measuredUs + WARM_UP_MARGIN_US > warmUpUs) {
+    // Sobe imediatamente: um despertar tardio custa um prazo perdido
+    warmUpUs = measuredUs + WARM_UP_MARGIN_US;
+  } else {
+    // Desce devagar, um oitavo da diferença por ciclo
+    warmUpUs -= (warmUpUs - measuredUs - WARM_UP_MARGIN_US) / 8;
+  }
+}
@@ -0,0 +1,127 @@
+#ifndef CYCLE_SCHEDULER_H
+#define CYCLE_SCHEDULER_H
+
+/**
+ * @file CycleScheduler.h
+ * @brief Duty-cycled acquisition scheduling, independent of the hardware.
+ *
+ * The firmware supplies a SchedulerPlatform backed by esp_timer, FreeRTOS
+ * and the peripherals; tools/dutycycle_sim supplies a simulated one to check
+ * deadlines and idle-time accounting on the host.
+ */
+
+#include <stdint.h>
+
+/**
+ * @class SchedulerPlatform
+ * @brief Time base and power controls used by CycleScheduler.
+ */
+class SchedulerPlatform {
+ public:
+  virtual ~SchedulerPlatform() { }
+
+  /**
+   * @brief Monotonic time in microseconds.
+   */
+  virtual uint64_t nowUs() = 0;
+
+  /**
+   * @brief Waits until the given time.
+   * @param deadlineUs The time to wait for.
+   * @param lowPower true if the platform may reduce the CPU clock or sleep.
+   * @return false if the wait was interrupted early by an external event
+   * (e.g. a command from the client).
+   */
+  virtual bool idleUntilUs(uint64_t deadlineUs, bool lowPower) = 0;
+
+  /**
+   * @brief Turns off the excitation and the multiplexer.
+   */
+  virtual void powerDownPeripherals() = 0;
+
+  /**
+   * @brief Turns the peripherals back on and waits for them to settle.
+   */
+  virtual void powerUpPeripherals() = 0;
+};
+
+/**
+ * @brief Scheduler parameters, in microseconds.
+ */
+struct SchedulerConfig {
+  uint32_t periodUs;             // Intervalo entre inícios de ciclo
+  uint32_t minLowPowerUs;        // Intervalo mínimo que compensa desligar
+  uint32_t initialWarmUpUs;      // Estimativa inicial do warm-up
+  uint32_t deadlineToleranceUs;  // Atraso aceito no início de um ciclo
+};
+
+/**
+ * @brief Time accounting since boot, in microseconds.
+ */
+struct SchedulerStats {
+  uint32_t cycles = 0;
+  uint32_t missedDeadlines = 0;  // Ciclos iniciados além da tolerância
+  uint32_t overruns = 0;         // Ciclos mais longos que o período
+  uint32_t interruptions = 0;    // Esperas encerradas por um evento
+  uint32_t maxLatenessUs = 0;
+  uint64_t workUs = 0;
+  uint64_t lowPowerUs = 0;  // Periféricos desligados e CPU em baixo consumo
+  uint64_t idleUs = 0;      // Espera com tudo ligado (intervalos curtos)
+  uint64_t warmUpUs = 0;    // Religando os periféricos
+};
+
+/**
+ * @class CycleScheduler
+ * @brief Plans fixed-period cycle deadlines and spends the gaps between
+ * cycles at low power.
+ *
+ * Deadlines advance by exactly one period, so short delays do not
+ * accumulate. A cycle longer than the period starts the next one
+ * immediately and re-plans from there instead of bursting to catch up. Low
+ * power is only used when the gap exceeds minLowPowerUs plus the warm-up,
+ * and the scheduler wakes early by the warm-up measured on previous cycles
+ * (wake-up latency plus peripheral power-up), so the cycle still starts on
+ * time.
+ */
+class CycleScheduler {
+ public:
+  CycleScheduler(SchedulerPlatform& platform, const SchedulerConfig& config);
+
+  /**
+   * @brief Marks the start of a cycle and checks it against its deadline.
+   * @return The start time in microseconds.
+   */
+  uint64_t beginCycle();
+
+  /**
+   * @brief Idles until the next cycle deadline. The peripherals are powered
+   * again when this returns.
+   * @return false if the wait was interrupted by an external event.
+   */
+  bool waitForNextCycle();
+
+  /**
+   * @brief Forgets the current plan; the next beginCycle() starts a new one.
+   * Used after acquisition outside the scheduler (monitoring mode).
+   */
+  void resync();
+
+  const SchedulerStats& stats() const { return counters; }
+  uint32_t warmUpEstimateUs() const { return warmUpUs; }
+  uint32_t periodUs() const { return config.periodUs; }
+
+ private:
+  SchedulerPlatform& platform;
+  const SchedulerConfig config;
+  SchedulerStats counters;
+
+  bool planned = false;
+  uint64_t nextDeadlineUs = 0;
+  uint64_t cycleStartUs = 0;
+  uint64_t plannedStartUs = 0;
+  uint32_t warmUpUs;
+
+  void updateWarmUp(uint32_t measuredUs);
+};
+
+#endif  // CYCLE_SCHEDULER_H
@@ -0,0 +1,161 @@
+#include "DriftCompensator.h"
+
+#include <math.h>
+
+DriftCompensator::DriftCompensator(EnvironmentSensor sensor) : sensor(sensor) {
+  reset();
+}
+
+void DriftCompensator::selectSensor(EnvironmentSensor newSensor) {
+  sensor = newSensor;
+  reset();
+}
+
+void DriftCompensator::reset() {
+  for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+    resetModel(models[i]);
+  }
+  cycles = 0;
+  referenceTemperature = NAN;
+  referenceHumidity = NAN;
+  lastTemperature = NAN;
+  lastHumidity = NAN;
+}
+
+void DriftCompensator::resetModel(PointModel& model) {
+  model.theta[0] = model.theta[1] = model.theta[2] = 0.0f;
+  model.p[0] = model.p[3] = model.p[5] = INITIAL_COVARIANCE;
+  model.p[1] = model.p[2] = model.p[4] = 0.0f;
+  model.residualVariance = 0.0f;
+  model.gatedCycles = 0;
+}
+
+void DriftCompensator::update(PointModel& model, const float x[3], float y) {
+  float* p = model.p;
+
+  // P * x usando a simetria de P
+  float px[3] = {
+      p[0] * x[0] + p[1] * x[1] + p[2] * x[2],
+      p[1] * x[0] + p[3] * x[1] + p[4] * x[2],
+      p[2] * x[0] + p[4] * x[1] + p[5] * x[2],
+  };
+
+  const float lambda = FORGETTING_FACTOR;
+  float denom = lambda + x[0] * px[0] + x[1] * px[1] + x[2] * px[2];
+  float error = y - (model.theta[0] * x[0] + model.theta[1] * x[1] +
+                     model.theta[2] * x[2]);
+  for (int j = 0; j < 3; ++j) {
+    model.theta[j] += px[j] / denom * error;
+  }
+
+  // P = (P - P x xᵀ P / denom) / lambda
+  const int row[6] = {0, 0, 0, 1, 1, 2};
+  const int col[6] = {0, 1, 2, 1, 2, 2};
+  for (int k = 0; k < 6; ++k) {
+    p[k] = (p[k] - px[row[k]] * px[col[k]] / denom) / lambda;
+  }
+
+  // Com T/H constantes só o termo b0 é excitado e P11/P22 crescem 1/lambda
+  // por ciclo. Cada variância é limitada por P' = S P S, S = diag(s_i),
+  // s_i = min(1, sqrt(MAX / P_ii)): P continua positiva semidefinida e o
+  // esquecimento de b0 segue ativo, acompanhando o envelhecimento
+  const int diagonal[3] = {0, 3, 5};
+  float scale[3];
+  for (int j = 0; j < 3; ++j) {
+    float variance = p[diagonal[j]];
+    scale[j] = variance > MAX_PARAMETER_VARIANCE
+                   ? sqrtf(MAX_PARAMETER_VARIANCE / variance)
+                   : 1.0f;
+  }
+  for (int k = 0; k < 6; ++k) {
+    p[k] *= scale[row[k]] * scale[col[k]];
+  }
+}
+
+bool DriftCompensator::compensate(
+    const DataPacket& packet, CompensatedFeatures& features
+) {
+  features.sequence = packet.sequence;
+  features.gated_mask = 0;
+
+  // Sempre o mesmo sensor: trocar para o outro numa falha de leitura
+  // introduziria o desvio entre eles como um degrau em dT/dH
+  float temperature = packet.sht_temperature;
+  float humidity = packet.sht_humidity;
+  if (sensor == SENSOR_BME680) {
+    temperature = packet.bme_temperature;
+    humidity = packet.bme_humidity;
+  }
+  bool environmentValid = !isnan(temperature) && !isnan(humidity);
+
+  if (environmentValid) {
+    lastTemperature = temperature;
+    lastHumidity = humidity;
+  } else {
+    temperature = lastTemperature;
+    humidity = lastHumidity;
+  }
+
+  // Sem nenhuma leitura ambiental ainda não há referência
+  if (isnan(temperature)) {
+    for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+      features.adc_corrected[i] = NAN;
+    }
+    return false;
+  }
+
+  if (cycles == 0) {
+    referenceTemperature = temperature;
+    referenceHumidity = humidity;
+    // Parte da primeira medição para evitar um transitório inicial
+    for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+      models[i].theta[0] = packet.adc_mean[i];
+    }
+  }
+
+  const float x[3] = {
+      1.0f, temperature - referenceTemperature, humidity - referenceHumidity
+  };
+
+  for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+    PointModel& model = models[i];
+    float y = packet.adc_mean[i];
+    float residual = y - (model.theta[0] * x[0] + model.theta[1] * x[1] +
+                          model.theta[2] * x[2]);
+    features.adc_corrected[i] = residual;
+
+    if (!environmentValid || isnan(y)) {
+      continue;
+    }
+
+    // Resíduo fora do ruído recente: provável exposição a odor, a linha de
+    // base fica congelada (por no máximo MAX_GATED_CYCLES ciclos)
+    bool gated = cycles >= WARMUP_CYCLES &&
+                 model.gatedCycles < MAX_GATED_CYCLES &&
+                 residual * residual >
+                     GATE_SIGMAS * GATE_SIGMAS * model.residualVariance;
+    if (gated) {
+      model.gatedCycles++;
+      features.gated_mask |= 1UL << i;
+      continue;
+    }
+
+    // Bloqueio esgotado: mudança permanente, b0 volta a ser incerto para
+    // saltar ao novo nível em vez de ficar preso ao antigo
+    if (model.gatedCycles >= MAX_GATED_CYCLES) {
+      model.p[0] += INITIAL_COVARIANCE;
+    }
+    model.gatedCycles = 0;
+    // Média simples no aquecimento, exponencial depois
+    float weight = cycles < WARMUP_CYCLES ? 1.0f / (cycles + 1)
+                                          : 1.0f - FORGETTING_FACTOR;
+    model.residualVariance +=
+        weight * (residual * residual - model.residualVariance);
+    update(model, x, y);
+  }
+
+  if (environmentValid) {
+    cycles++;
+  }
+  return environmentValid;
+}
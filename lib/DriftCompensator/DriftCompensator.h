@@ -0,0 +1,96 @@
+#ifndef DRIFT_COMPENSATOR_H
+#define DRIFT_COMPENSATOR_H
+
+#include "SensorData.h"
+
+/**
+ * @class DriftCompensator
+ * @brief Tracks the clean-air baseline of every lock-in point as a function
+ * of temperature and humidity and removes it from each new cycle.
+ *
+ * Each point keeps a 3-parameter recursive least-squares model
+ * baseline = b0 + b1 * dT + b2 * dH, where dT and dH are measured from the
+ * conditions of the first cycle. A forgetting factor lets the model follow
+ * slow sensor aging; the variance of each parameter is capped so that
+ * directions left unexcited by constant conditions cannot wind up. Cycles
+ * whose residual is far outside the recent noise level (an odor exposure)
+ * do not update the baseline. Memory and per-cycle cost are fixed: a few
+ * floats and a 3x3 update per point.
+ *
+ * Temperature and humidity come from a single sensor for the whole run: the
+ * SHT31 and the BME680 read several degrees and %RH apart, so mixing them
+ * would show up as a step in the regressors. A failed reading holds the
+ * last value of the same sensor and skips the update.
+ */
+class DriftCompensator {
+ public:
+  /**
+   * @brief Source of the temperature/humidity regressors.
+   */
+  enum EnvironmentSensor : uint8_t {
+    SENSOR_SHT31,   // Mais preciso; padrão
+    SENSOR_BME680,  // Para placas sem SHT31 (ou com falha na inicialização)
+  };
+
+  explicit DriftCompensator(EnvironmentSensor sensor = SENSOR_SHT31);
+
+  /**
+   * @brief Switches the environment sensor and discards every baseline,
+   * since the reference conditions of the old sensor no longer apply.
+   */
+  void selectSensor(EnvironmentSensor sensor);
+
+  /**
+   * @brief Compensates one measurement cycle and updates the baselines.
+   *
+   * @param packet The packet produced at the end of the sweep.
+   * @param features Receives the drift-corrected features for the packet.
+   * @return false if no valid temperature/humidity reading was available; the
+   * features are then corrected with the last known conditions and the
+   * baselines are not updated.
+   */
+  bool compensate(const DataPacket& packet, CompensatedFeatures& features);
+
+  /**
+   * @brief Discards every baseline; the next cycle becomes the reference.
+   */
+  void reset();
+
+  // --- Parâmetros do filtro ---
+  static constexpr float FORGETTING_FACTOR = 0.98f;  // ~50 ciclos de memória
+  static constexpr float INITIAL_COVARIANCE = 1000.0f;
+  // Teto da variância de cada parâmetro: evita o windup das direções sem
+  // excitação sem suspender o esquecimento das demais
+  static constexpr float MAX_PARAMETER_VARIANCE = INITIAL_COVARIANCE;
+  // Sem bloqueio no início: o resíduo só tem nível estável depois de uma
+  // memória do filtro (o atraso sobre uma deriva leva ~1/(1-lambda) ciclos)
+  static constexpr int WARMUP_CYCLES = 50;
+  static constexpr float GATE_SIGMAS = 4.0f;    // Limiar do resíduo
+  static constexpr int MAX_GATED_CYCLES = 30;   // Readquire após mudança
+                                                // permanente
+
+ private:
+  /**
+   * @brief RLS state of one point. P is symmetric, so only its upper
+   * triangle is stored.
+   */
+  struct PointModel {
+    float theta[3];
+    float p[6];              // P00 P01 P02 P11 P12 P22
+    float residualVariance;  // Média exponencial do resíduo²
+    uint16_t gatedCycles;    // Ciclos consecutivos bloqueados
+  };
+
+  PointModel models[ADC_DATA_POINTS];
+  EnvironmentSensor sensor;
+  uint32_t cycles;
+  float referenceTemperature;
+  float referenceHumidity;
+  float lastTemperature;
+  float lastHumidity;
+
+  static void resetModel(PointModel& model);
+  static void update(PointModel& model, const float x[3], float y);
+};
+
+#endif  // DRIFT_COMPENSATOR_H
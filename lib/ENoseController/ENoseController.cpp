@@ -1,7 +1,5 @@
 #include "ENoseController.h"
 
-#include <cmath>  // Necessário para sin, cos, sqrt
-
 ENoseController::ENoseController(
     WaveGenerator& waveGenerator,
     Multiplexer& multiplexer,
@@ -19,77 +17,100 @@ void ENoseController::init() {
   adc.init();
 }
 
-LockInResult ENoseController::performLockInMeasurement(
-    long frequencyHz, int channel, int num_readings, int samples_per_reading
-) {
-  // 1. Configura as condições e aguarda o assentamento
-  waveGenerator.setFrequency(
-      frequencyHz
-  );  // Assume que a WaveGenerator tem um método setFrequency
+void ENoseController::selectPoint(long frequencyHz, int channel) {
+  // Configura as condições e aguarda o assentamento
+  waveGenerator.setFrequency(frequencyHz);
   multiplexer.enableChannel(channel);
   delayMicroseconds(waveSettlingTimeUs);
+}
 
-  std::vector<float> amplitude_results;
-  amplitude_results.reserve(num_readings);
+int16_t ENoseController::readCode() {
+  uint16_t raw_value = adc.readValue();
+  // O ADC é diferencial: descarta o último bit (zero) mantendo o sinal
+  return (int16_t) raw_value >> 1;
+}
 
-  const float V_REF = 2.5f;  // Tensão de referência do ADC
+float ENoseController::readVoltage() {
+  // Converte o valor bruto para tensão
+  return (readCode() / 16384.0f) * V_REF;
+}
 
-  for (int i = 0; i < num_readings; ++i) {
-    double sum_I = 0.0;
-    double sum_Q = 0.0;
-    unsigned long start_time_us = micros();
+void ENoseController::powerDown() {
+  waveGenerator.powerDown();
+  multiplexer.disableAll();
+}
 
-    for (int k = 0; k < samples_per_reading; ++k) {
-      uint16_t raw_value = adc.readValue();
-      // Converte o valor bruto para tensão. O ADC é diferencial.
-      int16_t signed_value =
-          (int16_t) raw_value >> 1;  // Descarta o último bit (zero)
-      float voltage = (signed_value / 16384.0f) * V_REF;
+void ENoseController::powerUp() {
+  waveGenerator.powerUp();
+  delayMicroseconds(waveSettlingTimeUs);
+}
 
-      // Calcula o tempo atual em segundos para as ondas de referência
-      float t = (micros() - start_time_us) / 1000000.0f;
+LockInResult ENoseController::performLockInMeasurement(
+    long frequencyHz, int channel, int num_readings, int samples_per_reading
+) {
+  // 1. Configura as condições e aguarda o assentamento
+  selectPoint(frequencyHz, channel);
+
+  // 2. Leituras de amplitude e sua média/desvio padrão (LockIn.h)
+  return measureLockIn(
+      frequencyHz,
+      num_readings,
+      samples_per_reading,
+      [this]() { return readVoltage(); },
+      []() { return micros(); },
+      []() { vTaskDelay(1); }
+  );
+}
 
-      // Gera as referências e multiplica
-      float ref_sin = sin(2.0 * PI * frequencyHz * t);
-      float ref_cos = cos(2.0 * PI * frequencyHz * t);
+void ENoseController::beginMonitoring(
+    long frequencyHz, int channel, uint32_t minSegmentUs
+) {
+  selectPoint(frequencyHz, channel);
+  monitorLockIn.start(frequencyHz, minSegmentUs * 1e-6);
+  monitorSegmentUs = monitorLockIn.segmentSeconds() * 1e6;
+  monitorLastUs = micros();
+  monitorElapsedUs = 0;
+}
 
-      sum_I += voltage * ref_sin;
-      sum_Q += voltage * ref_cos;
+bool ENoseController::monitorStep(float& amplitude, float& phase) {
+  // Amostras até cobrir a duração do segmento (períodos inteiros). Cada
+  // amostra representa um intervalo de amostragem, então o segmento termina
+  // meio intervalo antes do limite: a cobertura fica centrada nos períodos
+  // inteiros e a componente DC não vaza para o resultado
+  uint64_t segmentStartUs = 0;
+  for (int k = 0;; ++k) {
+    // Tempo contínuo desde beginMonitoring(): as referências precisam manter
+    // a fase entre segmentos, e a diferença em 32 bits tolera o wrap de micros()
+    unsigned long now = micros();
+    uint32_t intervalUs = (uint32_t) (now - monitorLastUs);
+    monitorElapsedUs += intervalUs;
+    monitorLastUs = now;
+    if (k == 0) {
+      segmentStartUs = monitorElapsedUs;
+    } else if (monitorElapsedUs - segmentStartUs + intervalUs * 0.5 >=
+               monitorSegmentUs) {
+      break;
     }
-
-    // Calcula a média dos componentes I e Q
-    double mean_I = sum_I / samples_per_reading;
-    double mean_Q = sum_Q / samples_per_reading;
-
-    // Calcula a amplitude. O fator 2 é para normalizar a amplitude.
-    float amplitude = 2.0 * sqrt(mean_I * mean_I + mean_Q * mean_Q);
-    amplitude_results.push_back(amplitude);
-
-    vTaskDelay(1);
+    monitorLockIn.add(readVoltage(), monitorElapsedUs * 1e-6);
   }
+  bool ready = monitorLockIn.endSegment();
 
-  // 2. Calcula a Média e o Desvio Padrão das amplitudes
-  LockInResult result = {0.0f, 0.0f};
-  if (amplitude_results.empty()) {
-    return result;
-  }
+  // Libera a CPU para o idle task (watchdog) entre segmentos
+  vTaskDelay(1);
 
-  double sum = 0.0;
-  for (float val : amplitude_results) {
-    sum += val;
+  if (ready) {
+    amplitude = monitorLockIn.amplitude();
+    phase = monitorLockIn.phase();
   }
-  result.mean = sum / amplitude_results.size();
+  return ready;
+}
 
-  double sum_sq_diff = 0.0;
-  for (float val : amplitude_results) {
-    sum_sq_diff += (val - result.mean) * (val - result.mean);
-  }
-  // Usa a fórmula do desvio padrão da amostra (N-1) se N > 1
-  if (amplitude_results.size() > 1) {
-    result.std_dev = sqrt(sum_sq_diff / (amplitude_results.size() - 1));
-  } else {
-    result.std_dev = 0.0;
-  }
+void ENoseController::beginRawCapture(long frequencyHz, int channel) {
+  selectPoint(frequencyHz, channel);
+}
 
-  return result;
+void ENoseController::readRawBlock(int16_t* codes, int count) {
+  for (int k = 0; k < count; ++k) {
+    codes[k] = readCode();
+  }
 }
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <LTC2310.h>
+#include <LockIn.h>
 #include <Multiplexer.h>
 #include <WaveGenerator.h>
 
@@ -39,11 +40,82 @@ class ENoseController {
       long frequencyHz, int channel, int num_readings, int samples_per_reading
   );
 
+  /**
+   * @brief Prepara o modo de monitoramento contínuo em um único ponto.
+   *
+   * Seleciona a frequência e o canal, aguarda o assentamento e reinicia a
+   * janela deslizante do lock-in.
+   *
+   * @param frequencyHz A frequência a ser gerada e medida.
+   * @param channel O canal do multiplexer a ser ativado.
+   * @param minSegmentUs Intervalo mínimo entre dois resultados
+   * consecutivos. Cada segmento é arredondado para um número inteiro de
+   * períodos da referência e a janela tem MONITOR_WINDOW_SEGMENTS
+   * segmentos, ou seja, ao menos MONITOR_WINDOW_SEGMENTS períodos.
+   */
+  void beginMonitoring(long frequencyHz, int channel, uint32_t minSegmentUs);
+
+  /**
+   * @brief Lê um segmento de amostras (um número inteiro de períodos) do
+   * ponto monitorado.
+   *
+   * @param amplitude Recebe a amplitude da janela, se disponível.
+   * @param phase Recebe a fase da janela (radianos), se disponível.
+   * @return true se a janela já estava completa e um novo resultado foi
+   * produzido.
+   */
+  bool monitorStep(float& amplitude, float& phase);
+
+  /**
+   * @brief Prepara a captura de amostras brutas em um ponto: seleciona a
+   * frequência e o canal e aguarda o assentamento.
+   *
+   * @param frequencyHz A frequência a ser gerada.
+   * @param channel O canal do multiplexer a ser ativado.
+   */
+  void beginRawCapture(long frequencyHz, int channel);
+
+  /**
+   * @brief Lê amostras consecutivas do ponto selecionado, sem demodular.
+   * Blocos seguidos continuam a mesma forma de onda (sem reassentamento).
+   *
+   * @param codes Recebe os códigos diferenciais do ADC (V = c/16384 * V_REF).
+   * @param count Número de amostras.
+   */
+  void readRawBlock(int16_t* codes, int count);
+
+  /**
+   * @brief Desliga a excitação (AD9833) e o multiplexer entre ciclos.
+   */
+  void powerDown();
+
+  /**
+   * @brief Religa a excitação e aguarda o assentamento. O canal é
+   * selecionado novamente pela próxima medição.
+   */
+  void powerUp();
+
+  /**
+   * @brief Número de segmentos sobrepostos da janela de monitoramento.
+   */
+  static const int MONITOR_WINDOW_SEGMENTS = 4;
+
  private:
   WaveGenerator& waveGenerator;
   Multiplexer& multiplexer;
   LTC2310& adc;
   int waveSettlingTimeUs;
+
+  const float V_REF = 2.5f;  // Tensão de referência do ADC
+
+  SlidingLockIn<MONITOR_WINDOW_SEGMENTS> monitorLockIn;
+  double monitorSegmentUs = 0.0;
+  unsigned long monitorLastUs = 0;
+  uint64_t monitorElapsedUs = 0;
+
+  void selectPoint(long frequencyHz, int channel);
+  int16_t readCode();
+  float readVoltage();
 };
 
 #endif  // E_NOSE_CONTROLLER_H
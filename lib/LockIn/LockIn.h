@@ -0,0 +1,238 @@
+#ifndef LOCK_IN_H
+#define LOCK_IN_H
+
+/**
+ * @file LockIn.h
+ * @brief Hardware-independent lock-in (I/Q) demodulation.
+ *
+ * No hardware is accessed here, so the same code runs in the firmware and in
+ * host tools fed with simulated samples (tools/lockin_bench).
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "SensorData.h"
+
+/**
+ * @class LockInAccumulator
+ * @brief Accumulates the in-phase and quadrature products of one window.
+ */
+class LockInAccumulator {
+ public:
+  /**
+   * @brief Sets the reference frequency and clears the sums.
+   */
+  void start(long frequencyHz) {
+    omega = 2.0 * M_PI * frequencyHz;
+    reset();
+  }
+
+  void reset() {
+    sumI = 0.0;
+    sumQ = 0.0;
+    count = 0;
+  }
+
+  /**
+   * @brief Adds one sample.
+   * @param voltage The ADC sample in volts.
+   * @param tSeconds Sample time on the same time base as the rest of the
+   * window; only differences matter for the amplitude.
+   */
+  void add(float voltage, double tSeconds) {
+    double angle = omega * tSeconds;
+    sumI += voltage * sin(angle);
+    sumQ += voltage * cos(angle);
+    count++;
+  }
+
+  /**
+   * @brief Merges the sums of another window demodulated on the same time
+   * base (used by SlidingLockIn).
+   */
+  void merge(const LockInAccumulator& other) {
+    sumI += other.sumI;
+    sumQ += other.sumQ;
+    count += other.count;
+  }
+
+  /**
+   * @brief Peak amplitude of the component at the reference frequency. The
+   * factor 2 compensates for the product averaging to half the amplitude.
+   */
+  float amplitude() const {
+    if (count == 0) {
+      return 0.0f;
+    }
+    double meanI = sumI / count;
+    double meanQ = sumQ / count;
+    return 2.0 * sqrt(meanI * meanI + meanQ * meanQ);
+  }
+
+  /**
+   * @brief Phase of the component relative to a sine at t = 0, in radians.
+   */
+  float phase() const { return atan2(sumQ, sumI); }
+
+  uint32_t samples() const { return count; }
+
+ private:
+  double omega = 0.0;
+  double sumI = 0.0;
+  double sumQ = 0.0;
+  uint32_t count = 0;
+};
+
+/**
+ * @brief Repeated lock-in readings of one point and their mean and sample
+ * standard deviation: the measurement behind
+ * ENoseController::performLockInMeasurement, with the hardware passed in.
+ *
+ * @param frequencyHz The reference frequency.
+ * @param numReadings Number of amplitude readings.
+ * @param samplesPerReading ADC samples per reading.
+ * @param readVoltage Callable returning the next ADC sample in volts.
+ * @param nowUs Callable returning the current time in microseconds (an
+ * unsigned long, like micros()).
+ * @param afterReading Callable run after each reading (e.g. to yield).
+ */
+template <class ReadVoltage, class NowUs, class AfterReading>
+LockInResult measureLockIn(
+    long frequencyHz,
+    int numReadings,
+    int samplesPerReading,
+    ReadVoltage&& readVoltage,
+    NowUs&& nowUs,
+    AfterReading&& afterReading
+) {
+  std::vector<float> amplitude_results;
+  amplitude_results.reserve(numReadings);
+
+  LockInAccumulator lockIn;
+  for (int i = 0; i < numReadings; ++i) {
+    lockIn.start(frequencyHz);
+    unsigned long start_time_us = nowUs();
+
+    for (int k = 0; k < samplesPerReading; ++k) {
+      float voltage = readVoltage();
+      // Tempo atual em segundos para as ondas de referência
+      float t = (nowUs() - start_time_us) / 1000000.0f;
+      lockIn.add(voltage, t);
+    }
+
+    amplitude_results.push_back(lockIn.amplitude());
+
+    afterReading();
+  }
+
+  // Média e desvio padrão das amplitudes
+  LockInResult result = {0.0f, 0.0f};
+  if (amplitude_results.empty()) {
+    return result;
+  }
+
+  double sum = 0.0;
+  for (float val : amplitude_results) {
+    sum += val;
+  }
+  result.mean = sum / amplitude_results.size();
+
+  double sum_sq_diff = 0.0;
+  for (float val : amplitude_results) {
+    sum_sq_diff += (val - result.mean) * (val - result.mean);
+  }
+  // Usa a fórmula do desvio padrão da amostra (N-1) se N > 1
+  if (amplitude_results.size() > 1) {
+    result.std_dev = sqrt(sum_sq_diff / (amplitude_results.size() - 1));
+  } else {
+    result.std_dev = 0.0;
+  }
+
+  return result;
+}
+
+/**
+ * @class SlidingLockIn
+ * @brief Overlapping-window lock-in for continuous monitoring.
+ *
+ * The window is split into `Segments` segments of equal duration, each a
+ * whole number of reference periods so that every segment (and the window)
+ * rejects the DC offset and the 2f product like a full lock-in reading.
+ * Each completed segment replaces the oldest one, and the window result is
+ * the sum of all segments, so a new amplitude/phase is produced every
+ * segment with (Segments - 1) / Segments overlap, at constant memory and
+ * O(Segments) work per output. The caller ends each segment once its
+ * samples span segmentSeconds().
+ */
+template <int Segments>
+class SlidingLockIn {
+ public:
+  static_assert(Segments > 0, "At least one segment is required");
+
+  /**
+   * @brief Restarts the window at a new frequency.
+   * @param frequencyHz The reference frequency.
+   * @param minSegmentSeconds Shortest interval between two consecutive
+   * outputs; it is rounded up to a whole number of periods (at least one).
+   */
+  void start(long frequencyHz, double minSegmentSeconds) {
+    periodsPerSegment = static_cast<int>(ceil(minSegmentSeconds * frequencyHz));
+    if (periodsPerSegment < 1) {
+      periodsPerSegment = 1;
+    }
+    segmentDuration = static_cast<double>(periodsPerSegment) / frequencyHz;
+    current.start(frequencyHz);
+    for (int s = 0; s < Segments; ++s) {
+      segments[s].start(frequencyHz);
+    }
+    window.start(frequencyHz);
+    filled = 0;
+    head = 0;
+  }
+
+  /**
+   * @brief Adds one sample to the current segment.
+   */
+  void add(float voltage, double tSeconds) { current.add(voltage, tSeconds); }
+
+  /**
+   * @brief Closes the current segment and starts the next one.
+   * @return true when a new window result is available.
+   */
+  bool endSegment() {
+    if (current.samples() == 0) {
+      return false;
+    }
+    segments[head] = current;
+    head = (head + 1) % Segments;
+    current.reset();
+    if (filled < Segments) {
+      filled++;
+    }
+
+    window.reset();
+    for (int s = 0; s < filled; ++s) {
+      window.merge(segments[s]);
+    }
+    return filled == Segments;
+  }
+
+  float amplitude() const { return window.amplitude(); }
+  float phase() const { return window.phase(); }
+  double segmentSeconds() const { return segmentDuration; }
+  int windowPeriods() const { return periodsPerSegment * Segments; }
+
+ private:
+  LockInAccumulator current;
+  LockInAccumulator segments[Segments];
+  LockInAccumulator window;
+  int periodsPerSegment = 1;
+  double segmentDuration = 0.0;
+  int filled = 0;
+  int head = 0;
+};
+
+#endif  // LOCK_IN_H
@@ -25,6 +25,13 @@ void Multiplexer::enableChannel(int channel) {
   digitalWrite(pins[enabledChannelIndex], HIGH);
 }
 
+void Multiplexer::disableAll() {
+  if (enabledChannelIndex != NO_CHANNEL_ENABLED) {
+    digitalWrite(pins[enabledChannelIndex], LOW);
+    enabledChannelIndex = NO_CHANNEL_ENABLED;
+  }
+}
+
 size_t Multiplexer::getChannelCount() const { return pins.size(); }
 
 bool Multiplexer::channelIsValid(int channel) const {
@@ -17,6 +17,15 @@ class Multiplexer {
    */
   Multiplexer(std::initializer_list<int> pins);
 
+  /**
+   * @brief Construct a new Multiplexer object from a pin array, so the
+   * channel count can be checked at compile time by the caller.
+   * @param pins An array of GPIO pin numbers for the channels.
+   */
+  template <size_t N>
+  Multiplexer(const int (&pins)[N])
+      : pins(pins, pins + N), enabledChannelIndex(NO_CHANNEL_ENABLED) { }
+
   /**
    * @brief Initializes GPIO pins.
    */
@@ -28,6 +37,11 @@ class Multiplexer {
    */
   void enableChannel(int channel);
 
+  /**
+   * @brief Disables every channel (no sensor connected).
+   */
+  void disableAll();
+
   /**
    * @brief Gets the total number of channels.
    * @return The number of channels.
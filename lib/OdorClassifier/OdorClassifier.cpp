@@ -0,0 +1,50 @@
+#include "OdorClassifier.h"
+
+#include <cmath>
+
+#include "OdorModel.h"
+
+OdorClassification OdorClassifier::classify(const DataPacket& packet) const {
+  // 1. Normalização z-score das features (mesma usada no treino)
+  alignas(16) float features[OdorModel::NUM_FEATURES];
+  for (int i = 0; i < OdorModel::NUM_FEATURES; ++i) {
+    features[i] = (packet.adc_mean[i] - OdorModel::FEATURE_MEAN[i]) *
+                  OdorModel::FEATURE_INV_STD[i];
+  }
+
+  // 2. Camada linear: um produto escalar por classe
+  float scores[OdorModel::NUM_CLASSES];
+  int best = 0;
+  for (int c = 0; c < OdorModel::NUM_CLASSES; ++c) {
+    float acc = OdorModel::BIAS[c];
+    for (int i = 0; i < OdorModel::NUM_FEATURES; ++i) {
+      acc += OdorModel::WEIGHTS[c][i] * features[i];
+    }
+    scores[c] = acc;
+    if (acc > scores[best]) {
+      best = c;
+    }
+  }
+
+  // 3. Softmax apenas para a confiança da classe vencedora
+  float sum_exp = 0.0f;
+  for (int c = 0; c < OdorModel::NUM_CLASSES; ++c) {
+    sum_exp += expf(scores[c] - scores[best]);
+  }
+  float probability = 1.0f / sum_exp;
+
+  OdorClassification result;
+  result.sequence = packet.sequence;
+  result.label = static_cast<uint8_t>(best);
+  result.confidence = static_cast<uint8_t>(lroundf(probability * 255.0f));
+  return result;
+}
+
+bool OdorClassifier::enabled() { return OdorModel::ENABLED; }
+
+const char* OdorClassifier::labelName(uint8_t label) {
+  if (label >= OdorModel::NUM_CLASSES) {
+    return "unknown";
+  }
+  return OdorModel::CLASS_NAMES[label];
+}
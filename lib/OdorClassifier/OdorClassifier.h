@@ -0,0 +1,38 @@
+#ifndef ODOR_CLASSIFIER_H
+#define ODOR_CLASSIFIER_H
+
+#include "SensorData.h"
+
+/**
+ * @class OdorClassifier
+ * @brief Runs the embedded odor model on a complete measurement cycle.
+ *
+ * The model parameters live in OdorModel.h as constexpr tables, so inference
+ * needs no heap and no runtime initialization: one z-score normalization of
+ * the lock-in means followed by a linear layer and a softmax.
+ */
+class OdorClassifier {
+ public:
+  /**
+   * @brief Classifies the odor present during one measurement cycle.
+   * @param packet The packet produced at the end of the sweep.
+   * @return The most likely class and its softmax probability.
+   */
+  OdorClassification classify(const DataPacket& packet) const;
+
+  /**
+   * @brief Tells whether the exported model passed the trainer's accuracy
+   * gate. A disabled model must not be used: its results are no better than
+   * chance.
+   */
+  static bool enabled();
+
+  /**
+   * @brief Gets the human-readable name of a class label.
+   * @param label The label returned by classify().
+   * @return The class name, or "unknown" if the label is out of range.
+   */
+  static const char* labelName(uint8_t label);
+};
+
+#endif  // ODOR_CLASSIFIER_H
@@ -0,0 +1,82 @@
+#ifndef ODOR_MODEL_H
+#define ODOR_MODEL_H
+
+/**
+ * @file OdorModel.h
+ * @brief Parameters of the on-device odor classifier.
+ *
+ * ARQUIVO GERADO por tools/trainer - não editar manualmente.
+ * Modelo: regressão softmax sobre adc_mean normalizado (z-score).
+ * Amostras de treino: empty=402, negative=2194, positive=2048.
+ * Acurácia balanceada (validação cruzada por arquivo): 0.350.
+ * DESATIVADO: acurácia abaixo do mínimo do treinador; o firmware não
+ * classifica até que um modelo aprovado seja exportado.
+ */
+
+#include "SensorData.h"
+
+namespace OdorModel {
+
+constexpr bool ENABLED = false;
+constexpr int NUM_FEATURES = 24;
+constexpr int NUM_CLASSES = 3;
+
+static_assert(
+    NUM_FEATURES == ADC_DATA_POINTS,
+    "OdorModel was trained for a different scan shape; regenerate it."
+);
+
+constexpr const char* CLASS_NAMES[NUM_CLASSES] = {"empty", "negative", "positive"};
+
+alignas(16) constexpr float FEATURE_MEAN[NUM_FEATURES] = {
+    3.61085176e-01f, 3.61674577e-01f, 3.61385196e-01f, 3.61397326e-01f,
+    5.81795394e-01f, 5.82262754e-01f, 5.81790626e-01f, 5.81891239e-01f,
+    5.58946967e-01f, 5.59271693e-01f, 5.58985114e-01f, 5.58564901e-01f,
+    5.12543976e-01f, 5.12595952e-01f, 5.12594163e-01f, 5.12590110e-01f,
+    2.83357292e-01f, 2.83438891e-01f, 2.83441782e-01f, 2.83579320e-01f,
+    1.75095886e-01f, 1.75369218e-01f, 1.75136089e-01f, 1.75355658e-01f,
+};
+
+alignas(16) constexpr float FEATURE_INV_STD[NUM_FEATURES] = {
+    4.15811691e+01f, 4.04132195e+01f, 4.17372284e+01f, 4.11885223e+01f,
+    3.08954182e+01f, 3.01234188e+01f, 3.13574295e+01f, 3.13695507e+01f,
+    5.42052422e+01f, 5.98983727e+01f, 5.39369659e+01f, 4.78863220e+01f,
+    1.92973042e+01f, 1.93102818e+01f, 1.96041489e+01f, 1.95298004e+01f,
+    7.61400127e+00f, 7.61570215e+00f, 7.60207796e+00f, 7.60625219e+00f,
+    1.03454742e+01f, 1.03635464e+01f, 1.03595505e+01f, 1.03675251e+01f,
+};
+
+alignas(16) constexpr float WEIGHTS[NUM_CLASSES][NUM_FEATURES] = {
+    {
+        -7.18133748e-02f, -1.10515311e-01f, 9.36468914e-02f, -1.11478046e-01f,
+        -4.91437376e-01f, -3.80642712e-01f, -1.06902026e-01f, -2.25225016e-02f,
+        8.73865336e-02f, 4.36501384e-01f, 3.51682335e-01f, 1.31193650e+00f,
+        -4.18022603e-01f, -3.20435017e-01f, -6.16694927e-01f, -4.06830281e-01f,
+        -4.14161861e-01f, -3.69735003e-01f, -2.71573484e-01f, -2.85642475e-01f,
+        -4.49188262e-01f, -6.50645852e-01f, -1.70391053e-01f, -5.22633970e-01f,
+    },
+    {
+        -8.28187019e-02f, -5.78649566e-02f, -1.85519680e-02f, 1.22136004e-01f,
+        -3.96962881e-01f, -4.68936898e-02f, 1.19201049e-01f, -5.86241663e-01f,
+        2.22835585e-01f, 2.40660772e-01f, 1.21651500e-01f, -3.16982985e-01f,
+        -5.14368832e-01f, -5.71210265e-01f, 1.29535392e-01f, 7.52564669e-02f,
+        4.16047484e-01f, 3.47009897e-01f, 1.57800272e-01f, 3.33314031e-01f,
+        2.35075220e-01f, 3.05665761e-01f, 1.21140108e-01f, 5.11515498e-01f,
+    },
+    {
+        1.54632047e-01f, 1.68380082e-01f, -7.50949532e-02f, -1.06580192e-02f,
+        8.88399661e-01f, 4.27536517e-01f, -1.22992713e-02f, 6.08763695e-01f,
+        -3.10221761e-01f, -6.77162468e-01f, -4.73333746e-01f, -9.94953394e-01f,
+        9.32390094e-01f, 8.91645908e-01f, 4.87159848e-01f, 3.31573516e-01f,
+        -1.88580633e-03f, 2.27248203e-02f, 1.13773361e-01f, -4.76717502e-02f,
+        2.14112610e-01f, 3.44980538e-01f, 4.92510386e-02f, 1.11182975e-02f,
+    },
+};
+
+constexpr float BIAS[NUM_CLASSES] = {
+    -2.10044289e+00f, 1.04568624e+00f, 1.05475760e+00f,
+};
+
+}  // namespace OdorModel
+
+#endif  // ODOR_MODEL_H
@@ -0,0 +1,52 @@
+#ifndef PACKET_TRANSPORT_H
+#define PACKET_TRANSPORT_H
+
+/**
+ * @file PacketTransport.h
+ * @brief Common interface of the links that carry the device output
+ * (BLEManager, SerialLink). dataTransferTask writes every queued result to
+ * each of them.
+ */
+
+#include <stddef.h>
+
+#include "SensorData.h"
+
+/**
+ * @class PacketTransport
+ * @brief A link to a client. Every send returns false (or 0) when no client
+ * is connected or the link refused the data; the caller does not retry.
+ */
+class PacketTransport {
+ public:
+  virtual ~PacketTransport() { }
+
+  /**
+   * @brief Checks whether a client is listening on this link.
+   */
+  virtual bool isConnected() const = 0;
+
+  /**
+   * @brief Sends several DataPackets, in order.
+   * @return Number of packets accepted.
+   */
+  virtual size_t sendData(const DataPacket* packets, size_t count) = 0;
+
+  virtual bool sendClassification(const OdorClassification& classification) = 0;
+  virtual bool sendCompensatedFeatures(const CompensatedFeatures& features) = 0;
+  virtual bool sendMonitorBatch(const MonitorBatch& batch) = 0;
+
+  /**
+   * @brief Sends a block of raw ADC samples. Links too slow for bulk data
+   * return false.
+   */
+  virtual bool sendRawSamples(const RawSampleBlock& block) = 0;
+
+  /**
+   * @brief Processes incoming data (commands). Called periodically by
+   * dataTransferTask; links driven by callbacks do nothing.
+   */
+  virtual void poll() { }
+};
+
+#endif  // PACKET_TRANSPORT_H
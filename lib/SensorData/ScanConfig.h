@@ -0,0 +1,124 @@
+#ifndef SCAN_CONFIG_H
+#define SCAN_CONFIG_H
+
+/**
+ * @file ScanConfig.h
+ * @brief Compile-time description of the frequency x channel sweep.
+ *
+ * Every size, table and loop bound that depends on the scan shape is derived
+ * here from the template parameters, so the firmware, the packet layout and
+ * the host tools cannot disagree about it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+
+/**
+ * @brief Largest attribute value a BLE notification can carry (ATT_MTU 517
+ * minus the 3-byte header, capped by the 512-byte attribute limit).
+ */
+constexpr size_t BLE_MAX_ATTRIBUTE_SIZE = 512;
+
+/**
+ * @struct ScanConfig
+ * @brief A sweep over `NumChannels` mux channels at each of `FrequenciesHz`.
+ *
+ * Points are ordered frequency-major: point i is frequency i / NUM_CHANNELS
+ * and channel i % NUM_CHANNELS + 1, which is also the index into adc_mean
+ * and adc_std_dev.
+ */
+template <int NumChannels, long... FrequenciesHz>
+struct ScanConfig {
+  static_assert(NumChannels > 0, "At least one channel is required");
+  static_assert(sizeof...(FrequenciesHz) > 0, "At least one frequency is required");
+
+  static constexpr int NUM_CHANNELS = NumChannels;
+  static constexpr int NUM_FREQUENCIES = sizeof...(FrequenciesHz);
+  static constexpr int DATA_POINTS = NUM_FREQUENCIES * NUM_CHANNELS;
+
+  static constexpr long FREQUENCIES_HZ[NUM_FREQUENCIES] = {FrequenciesHz...};
+
+  /**
+   * @struct Point
+   * @brief One (frequency, channel) pair, fully known at compile time.
+   */
+  template <int Index>
+  struct Point {
+    static_assert(Index >= 0 && Index < DATA_POINTS, "Point out of range");
+    static constexpr int INDEX = Index;
+    static constexpr int FREQUENCY_INDEX = Index / NUM_CHANNELS;
+    static constexpr long FREQUENCY_HZ = FREQUENCIES_HZ[FREQUENCY_INDEX];
+    static constexpr int CHANNEL = Index % NUM_CHANNELS + 1;  // 1-based
+  };
+
+  /**
+   * @brief Frequency of a point chosen at runtime (e.g. by a BLE command).
+   */
+  static constexpr long frequencyOfPoint(int index) {
+    return FREQUENCIES_HZ[index / NUM_CHANNELS];
+  }
+
+  /**
+   * @brief Mux channel (1-based) of a point chosen at runtime.
+   */
+  static constexpr int channelOfPoint(int index) {
+    return index % NUM_CHANNELS + 1;
+  }
+
+  /**
+   * @brief Calls fn(Point<i>{}) for every point, in sweep order.
+   *
+   * The calls are expanded by the compiler, so the loop has no counter and
+   * every index used inside fn is a constant.
+   */
+  template <typename Fn>
+  static void forEachPoint(Fn&& fn) {
+    forEachPointImpl(fn, std::make_integer_sequence<int, DATA_POINTS>{});
+  }
+
+ private:
+  template <typename Fn, int... I>
+  static void forEachPointImpl(Fn& fn, std::integer_sequence<int, I...>) {
+    (fn(Point<I>{}), ...);
+  }
+};
+
+/**
+ * @struct BasicDataPacket
+ * @brief The packet sent over the FreeRTOS queue and over BLE, laid out for
+ * a given ScanConfig.
+ */
+#pragma pack(push, 1)  // Garante o empacotamento sem padding
+template <typename Scan>
+struct BasicDataPacket {
+  // Cabeçalho: permite ao receptor detectar perdas e alinhar dispositivos
+  uint32_t sequence;      // Número do ciclo desde o boot (começa em 0)
+  uint32_t timestamp_ms;  // millis() no início do ciclo
+
+  // BME680 Data
+  float bme_temperature;
+  float bme_humidity;
+  float bme_pressure;
+  float bme_gas_resistance;
+
+  // SHT31 Data
+  float sht_temperature;
+  float sht_humidity;
+
+  // MQ Sensor Data (Analog)
+  float mq3_value;
+  float mq135_value;
+  float mq136_value;
+  float mq137_value;
+
+  // Processed ADC Data from custom sensor
+  // Arrays para armazenar a média e o desvio padrão de cada combinação
+  // Frequência x Canal
+  float adc_mean[Scan::DATA_POINTS];
+  float adc_std_dev[Scan::DATA_POINTS];
+};
+#pragma pack(pop)
+
+#endif  // SCAN_CONFIG_H
@@ -6,11 +6,18 @@
  * @brief Defines the data structures for sensor readings and data packets.
  */
 
+#include <stdint.h>
+
+#include "ScanConfig.h"
+
 // --- Configuração do Sensor Fabricado ---
-// Altere estes valores para corresponder ao seu setup em main.cpp
-#define NUM_FREQUENCIAS 6
-#define NUM_CANAIS 4
-#define ADC_DATA_POINTS (NUM_FREQUENCIAS * NUM_CANAIS)
+// Único lugar onde a varredura é definida: número de canais do multiplexer
+// seguido das frequências (Hz), na ordem em que são medidas.
+using ActiveScan = ScanConfig<4, 100, 1000, 5000, 10000, 50000, 100000>;
+
+constexpr int NUM_FREQUENCIAS = ActiveScan::NUM_FREQUENCIES;
+constexpr int NUM_CANAIS = ActiveScan::NUM_CHANNELS;
+constexpr int ADC_DATA_POINTS = ActiveScan::DATA_POINTS;
 
 /**
  * @struct BME680_Data
@@ -42,34 +49,124 @@ struct LockInResult {
 };
 
 /**
- * @struct DataPacket
  * @brief A comprehensive packet containing all sensor data for a single
  * measurement cycle. This is the structure that is sent through the FreeRTOS
  * queue and over BLE.
  */
-#pragma pack(push, 1)  // Garante o empacotamento sem padding
-struct DataPacket {
-  // BME680 Data
-  float bme_temperature;
-  float bme_humidity;
-  float bme_pressure;
-  float bme_gas_resistance;
-
-  // SHT31 Data
-  float sht_temperature;
-  float sht_humidity;
-
-  // MQ Sensor Data (Analog)
-  float mq3_value;
-  float mq135_value;
-  float mq136_value;
-  float mq137_value;
-
-  // Processed ADC Data from custom sensor
-  // Arrays para armazenar a média e o desvio padrão de cada combinação
-  // Frequência x Canal
-  float adc_mean[ADC_DATA_POINTS];
-  float adc_std_dev[ADC_DATA_POINTS];
+using DataPacket = BasicDataPacket<ActiveScan>;
+
+static_assert(
+    sizeof(DataPacket) ==
+        2 * sizeof(uint32_t) + sizeof(float) * (10 + 2 * ADC_DATA_POINTS),
+    "DataPacket must not contain padding"
+);
+static_assert(
+    sizeof(DataPacket) <= BLE_MAX_ATTRIBUTE_SIZE,
+    "DataPacket no longer fits in a single BLE notification"
+);
+
+/**
+ * @struct OdorClassification
+ * @brief Result of the on-device classifier for one measurement cycle.
+ * Sent over BLE on its own characteristic, after the DataPacket with the
+ * same sequence number.
+ */
+#pragma pack(push, 1)
+struct OdorClassification {
+  uint32_t sequence;   // Mesmo número do DataPacket de origem
+  uint8_t label;       // Índice da classe em OdorModel::CLASS_NAMES
+  uint8_t confidence;  // Probabilidade da classe escalada para 0..255
+};
+
+/**
+ * @struct CompensatedFeatures
+ * @brief Drift-corrected lock-in means for one measurement cycle, produced
+ * by DriftCompensator and sent on their own characteristic after the
+ * DataPacket with the same sequence number.
+ */
+struct CompensatedFeatures {
+  uint32_t sequence;    // Mesmo número do DataPacket de origem
+  uint32_t gated_mask;  // Bit i: ponto i fora da linha de base (evento)
+  float adc_corrected[ADC_DATA_POINTS];  // adc_mean - linha de base
+};
+#pragma pack(pop)
+
+static_assert(
+    ADC_DATA_POINTS <= 32, "gated_mask holds one bit per lock-in point"
+);
+
+// --- Modo de monitoramento contínuo ---
+#define MAX_MONITOR_POINTS 8
+#define MONITOR_BATCH_SIZE 32
+
+/**
+ * @brief Operating modes selectable at runtime through MonitorCommand.
+ */
+enum AcquisitionMode : uint8_t {
+  MODE_SWEEP = 0,        // Varredura completa de todos os pontos (padrão)
+  MODE_MONITOR = 1,      // Fluxo contínuo de um pequeno conjunto de pontos
+  MODE_RAW_CAPTURE = 2,  // Blocos de amostras brutas, depois volta à varredura
+};
+
+/**
+ * @struct MonitorCommand
+ * @brief Written by the client to switch between sweep, monitoring and raw
+ * capture. Shorter writes are accepted; missing bytes are taken as zero.
+ */
+#pragma pack(push, 1)
+struct MonitorCommand {
+  uint8_t mode;                 // AcquisitionMode
+  uint8_t num_points;           // Pontos válidos em `points`
+  uint16_t baseline_interval_s; // Varredura completa a cada N s (0 = nunca)
+  uint8_t points[MAX_MONITOR_POINTS];  // Índices em adc_mean
+  uint16_t raw_blocks;          // MODE_RAW_CAPTURE: blocos por ponto (0 = 1)
+};
+
+/**
+ * @struct MonitorSample
+ * @brief One sliding-window lock-in result.
+ */
+struct MonitorSample {
+  uint32_t timestamp_us;  // micros() no fim da janela
+  uint8_t point;          // Índice do ponto (frequência x canal)
+  float amplitude;        // Amplitude de pico (V)
+  float phase;            // Fase em radianos
+};
+
+/**
+ * @struct MonitorBatch
+ * @brief Several MonitorSamples coalesced into one BLE notification. Only
+ * the first `count` samples are transmitted.
+ */
+struct MonitorBatch {
+  uint32_t sequence;  // Contador de lotes desde o boot
+  uint8_t count;
+  MonitorSample samples[MONITOR_BATCH_SIZE];
+};
+#pragma pack(pop)
+
+static_assert(
+    sizeof(MonitorBatch) <= BLE_MAX_ATTRIBUTE_SIZE,
+    "MonitorBatch no longer fits in a single BLE notification"
+);
+
+// --- Captura de amostras brutas (somente pela serial) ---
+#define RAW_BLOCK_SAMPLES 1024
+
+/**
+ * @struct RawSampleBlock
+ * @brief Consecutive ADC codes read at one point, for offline analysis of
+ * the demodulation. Too large for a BLE notification, so it only travels
+ * over the serial link. Only the first `count` samples are transmitted.
+ */
+#pragma pack(push, 1)
+struct RawSampleBlock {
+  uint32_t sequence;     // Contador de blocos desde o boot
+  uint32_t start_us;     // micros() antes da primeira amostra
+  uint32_t duration_us;  // Da primeira à última amostra
+  uint8_t point;         // Índice do ponto (frequência x canal)
+  uint16_t count;
+  int16_t samples[RAW_BLOCK_SAMPLES];  // Código do ADC: V = c / 16384 * 2,5
 };
 #pragma pack(pop)
 
@@ -0,0 +1,123 @@
+#include "SerialLink.h"
+
+#include <algorithm>
+
+SerialLink::SerialLink(HardwareSerial& serial)
+    : serial(serial),
+      commandQueue(NULL),
+      txSequence(0),
+      hostAttached(false),
+      lastHostFrameMs(0),
+      stats() { }
+
+void SerialLink::setCommandQueue(QueueHandle_t queue) { commandQueue = queue; }
+
+bool SerialLink::isConnected() const {
+  return hostAttached && millis() - lastHostFrameMs < SERIAL_HOST_TIMEOUT_MS;
+}
+
+void SerialLink::poll() {
+  int available = serial.available();
+  for (int i = 0; i < available; ++i) {
+    int byte = serial.read();
+    if (byte < 0) {
+      break;
+    }
+    DecodeResult result = decoder.push((uint8_t) byte);
+    if (result == DecodeResult::FRAME) {
+      handleFrame();
+    } else if (result == DecodeResult::ERROR) {
+      stats.receiveErrors++;
+    }
+  }
+}
+
+void SerialLink::handleFrame() {
+  bool wasConnected = isConnected();
+  hostAttached = true;
+  lastHostFrameMs = millis();
+  stats.framesReceived++;
+  if (!wasConnected) {
+    Serial.println("Serial host attached");
+  }
+
+  SerialResponse response;
+  response.request_type = decoder.type();
+  response.request_sequence = decoder.sequence();
+  response.status = SERIAL_STATUS_OK;
+
+  switch (decoder.type()) {
+    case FRAME_PING:
+      break;
+    case FRAME_COMMAND: {
+      size_t size = decoder.payloadSize();
+      if (size == 0 || size > sizeof(MonitorCommand)) {
+        response.status = SERIAL_STATUS_BAD_LENGTH;
+        break;
+      }
+      if (commandQueue == NULL) {
+        response.status = SERIAL_STATUS_UNAVAILABLE;
+        break;
+      }
+      // Bytes ausentes valem zero, como na característica de controle
+      MonitorCommand command = {};
+      memcpy(&command, decoder.payload(), size);
+      if (command.num_points > MAX_MONITOR_POINTS) {
+        command.num_points = MAX_MONITOR_POINTS;
+      }
+      xQueueOverwrite(commandQueue, &command);
+      break;
+    }
+    default:
+      response.status = SERIAL_STATUS_UNKNOWN_TYPE;
+      break;
+  }
+  sendFrame(FRAME_RESPONSE, &response, sizeof(response));
+}
+
+bool SerialLink::sendFrame(
+    SerialFrameType type, const void* payload, size_t size
+) {
+  if (!isConnected()) {
+    return false;
+  }
+  size_t length = encodeFrame(type, txSequence++, payload, size, txBuffer);
+  if (serial.write(txBuffer, length) != length) {
+    return false;
+  }
+  stats.framesSent++;
+  stats.bytesSent += length;
+  return true;
+}
+
+size_t SerialLink::sendData(const DataPacket* packets, size_t count) {
+  size_t sent = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (sendFrame(FRAME_DATA_PACKET, &packets[i], sizeof(DataPacket))) {
+      sent++;
+    }
+  }
+  return sent;
+}
+
+bool SerialLink::sendClassification(const OdorClassification& classification) {
+  return sendFrame(
+      FRAME_CLASSIFICATION, &classification, sizeof(OdorClassification)
+  );
+}
+
+bool SerialLink::sendCompensatedFeatures(const CompensatedFeatures& features) {
+  return sendFrame(FRAME_COMPENSATED, &features, sizeof(CompensatedFeatures));
+}
+
+bool SerialLink::sendMonitorBatch(const MonitorBatch& batch) {
+  size_t size =
+      offsetof(MonitorBatch, samples) + batch.count * sizeof(MonitorSample);
+  return sendFrame(FRAME_MONITOR_BATCH, &batch, size);
+}
+
+bool SerialLink::sendRawSamples(const RawSampleBlock& block) {
+  size_t count = std::min(block.count, (uint16_t) RAW_BLOCK_SAMPLES);
+  size_t size = offsetof(RawSampleBlock, samples) + count * sizeof(int16_t);
+  return sendFrame(FRAME_RAW_SAMPLES, &block, size);
+}
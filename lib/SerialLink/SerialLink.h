@@ -0,0 +1,91 @@
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+#include <Arduino.h>
+
+#include "PacketTransport.h"
+#include "SensorData.h"
+#include "SerialProtocol.h"
+
+// Sem nenhum quadro do host por este tempo, a porta volta a ter só logs
+#define SERIAL_HOST_TIMEOUT_MS 3000
+
+/**
+ * @struct SerialLinkStats
+ * @brief Serial link counters since boot.
+ */
+struct SerialLinkStats {
+  uint32_t framesSent;
+  uint32_t bytesSent;
+  uint32_t framesReceived;
+  uint32_t receiveErrors;  // Quadros do host com CRC ou COBS inválidos
+};
+
+/**
+ * @class SerialLink
+ * @brief Framed binary transport on the USB serial port (SerialProtocol.h).
+ *
+ * The port keeps carrying the text logs. Frames are only sent while a host
+ * is attached, i.e. has sent a valid frame (a PING at least) in the last
+ * SERIAL_HOST_TIMEOUT_MS, so a plain serial monitor never sees binary data.
+ * Each frame goes out in a single write(), which the Arduino core serializes
+ * against the logs printed by other tasks.
+ *
+ * Host commands use the same MonitorCommand as the BLE control
+ * characteristic and go to the same queue; every host frame is answered with
+ * a SerialResponse.
+ */
+class SerialLink : public PacketTransport {
+ public:
+  /**
+   * @brief Construct a new SerialLink object.
+   *
+   * @param serial The port, already started with begin().
+   */
+  SerialLink(HardwareSerial& serial);
+
+  /**
+   * @brief Sets the queue that receives MonitorCommands from the host, as in
+   * BLEManager::setCommandQueue().
+   *
+   * @param queue The FreeRTOS queue, or NULL to refuse commands.
+   */
+  void setCommandQueue(QueueHandle_t queue);
+
+  /**
+   * @brief Reads the bytes received so far and answers complete frames.
+   */
+  void poll() override;
+
+  bool isConnected() const override;
+  size_t sendData(const DataPacket* packets, size_t count) override;
+  bool sendClassification(const OdorClassification& classification) override;
+  bool sendCompensatedFeatures(const CompensatedFeatures& features) override;
+  bool sendMonitorBatch(const MonitorBatch& batch) override;
+  bool sendRawSamples(const RawSampleBlock& block) override;
+
+  const SerialLinkStats& getStats() const { return stats; }
+
+ private:
+  HardwareSerial& serial;
+  QueueHandle_t commandQueue;
+  FrameDecoder<sizeof(MonitorCommand)> decoder;
+  uint8_t txBuffer[serialFrameSize(SERIAL_MAX_PAYLOAD)];
+  uint8_t txSequence;
+  bool hostAttached;
+  unsigned long lastHostFrameMs;
+  SerialLinkStats stats;
+
+  /**
+   * @brief Encodes and writes one frame if a host is attached.
+   * @return true if the frame was written.
+   */
+  bool sendFrame(SerialFrameType type, const void* payload, size_t size);
+
+  /**
+   * @brief Executes the frame held by the decoder and answers it.
+   */
+  void handleFrame();
+};
+
+#endif  // SERIAL_LINK_H
@@ -0,0 +1,111 @@
+#include "SerialProtocol.h"
+
+namespace {
+
+/**
+ * Codificador COBS incremental: o quadro é codificado enquanto é montado,
+ * sem cópia intermediária do payload.
+ */
+class CobsWriter {
+ public:
+  explicit CobsWriter(uint8_t* out) : out(out) { }
+
+  void put(uint8_t byte) {
+    if (byte == 0) {
+      closeBlock();
+      return;
+    }
+    out[position++] = byte;
+    if (++code == 0xFF) {
+      closeBlock();
+    }
+  }
+
+  void put(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      put(data[i]);
+    }
+  }
+
+  size_t finish() {
+    out[codeIndex] = code;
+    return position;
+  }
+
+ private:
+  uint8_t* out;
+  size_t codeIndex = 0;
+  size_t position = 1;
+  uint8_t code = 1;
+
+  // O byte de código guarda a distância até o próximo zero (ou 0xFF para
+  // um bloco de 254 bytes sem zero)
+  void closeBlock() {
+    out[codeIndex] = code;
+    codeIndex = position++;
+    code = 1;
+  }
+};
+
+}  // namespace
+
+uint16_t crc16(const uint8_t* data, size_t size, uint16_t crc) {
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= static_cast<uint16_t>(data[i]) << 8;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+size_t cobsEncode(const uint8_t* data, size_t size, uint8_t* out) {
+  CobsWriter writer(out);
+  writer.put(data, size);
+  return writer.finish();
+}
+
+size_t cobsDecode(const uint8_t* data, size_t size, uint8_t* out) {
+  size_t in = 0;
+  size_t position = 0;
+  while (in < size) {
+    uint8_t code = data[in++];
+    if (code == 0 || in + code - 1 > size) {
+      return 0;
+    }
+    for (uint8_t k = 1; k < code; ++k) {
+      if (data[in] == 0) {
+        return 0;
+      }
+      out[position++] = data[in++];
+    }
+    // O zero implícito do fim do bloco não existe após o último bloco
+    if (code != 0xFF && in < size) {
+      out[position++] = 0;
+    }
+  }
+  return position;
+}
+
+size_t encodeFrame(
+    uint8_t type,
+    uint8_t sequence,
+    const void* payload,
+    size_t size,
+    uint8_t* out
+) {
+  const uint8_t header[FRAME_HEADER_SIZE] = {type, sequence};
+  uint16_t crc = crc16(header, sizeof(header));
+  crc = crc16(static_cast<const uint8_t*>(payload), size, crc);
+
+  // Delimitador inicial: encerra qualquer texto de log pendente no host
+  out[0] = 0;
+  CobsWriter writer(out + 1);
+  writer.put(header, sizeof(header));
+  writer.put(static_cast<const uint8_t*>(payload), size);
+  writer.put(static_cast<uint8_t>(crc & 0xFF));
+  writer.put(static_cast<uint8_t>(crc >> 8));
+  size_t length = 1 + writer.finish();
+  out[length++] = 0;
+  return length;
+}
@@ -0,0 +1,242 @@
+#ifndef SERIAL_PROTOCOL_H
+#define SERIAL_PROTOCOL_H
+
+/**
+ * @file SerialProtocol.h
+ * @brief Framed binary protocol of the USB serial link, independent of the
+ * hardware.
+ *
+ * Each frame is [type][sequence][payload][CRC-16], COBS-encoded and
+ * surrounded by 0x00 delimiters. COBS leaves no zero inside a frame, so the
+ * receiver resynchronizes on the next delimiter after any error, and the
+ * text logs printed on the same port (which never contain 0x00) end up
+ * between frames where they are told apart by the failed CRC.
+ *
+ * The firmware (lib/SerialLink) and the host library (tools/lib/SerialClient)
+ * share this code.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "SensorData.h"
+
+#define SERIAL_LINK_BAUD 921600
+
+/**
+ * @brief Frame types. The payload of each device frame is the same struct
+ * sent over BLE; variable-length structs only carry their valid entries.
+ */
+enum SerialFrameType : uint8_t {
+  // Dispositivo -> host
+  FRAME_DATA_PACKET = 0x01,     // DataPacket
+  FRAME_CLASSIFICATION = 0x02,  // OdorClassification
+  FRAME_COMPENSATED = 0x03,     // CompensatedFeatures
+  FRAME_MONITOR_BATCH = 0x04,   // MonitorBatch (count amostras)
+  FRAME_RAW_SAMPLES = 0x05,     // RawSampleBlock (count amostras)
+  FRAME_RESPONSE = 0x06,        // SerialResponse
+  // Host -> dispositivo
+  FRAME_PING = 0x80,     // Sem payload; também mantém o enlace ativo
+  FRAME_COMMAND = 0x81,  // MonitorCommand, como na característica de controle
+};
+
+/**
+ * @brief Outcome of a host request, returned in SerialResponse.
+ */
+enum SerialStatus : uint8_t {
+  SERIAL_STATUS_OK = 0,
+  SERIAL_STATUS_BAD_LENGTH = 1,
+  SERIAL_STATUS_UNKNOWN_TYPE = 2,
+  SERIAL_STATUS_UNAVAILABLE = 3,  // Sem fila de comandos
+};
+
+/**
+ * @struct SerialResponse
+ * @brief Device answer to every host frame.
+ */
+#pragma pack(push, 1)
+struct SerialResponse {
+  uint8_t request_type;      // SerialFrameType do pedido
+  uint8_t request_sequence;  // Sequência do pedido
+  uint8_t status;            // SerialStatus
+};
+#pragma pack(pop)
+
+// Tipo e sequência antes do payload, CRC depois
+constexpr size_t FRAME_HEADER_SIZE = 2;
+constexpr size_t FRAME_CRC_SIZE = 2;
+
+// Maior payload em qualquer sentido
+constexpr size_t SERIAL_MAX_PAYLOAD = sizeof(RawSampleBlock);
+static_assert(
+    sizeof(DataPacket) <= SERIAL_MAX_PAYLOAD &&
+        sizeof(MonitorBatch) <= SERIAL_MAX_PAYLOAD &&
+        sizeof(CompensatedFeatures) <= SERIAL_MAX_PAYLOAD,
+    "SERIAL_MAX_PAYLOAD must fit every frame"
+);
+
+/**
+ * @brief Worst-case COBS output for `size` input bytes.
+ */
+constexpr size_t cobsMaxEncodedSize(size_t size) {
+  return size + size / 254 + 1;
+}
+
+/**
+ * @brief Bytes written by encodeFrame() for a payload of `payloadSize`,
+ * both delimiters included.
+ */
+constexpr size_t serialFrameSize(size_t payloadSize) {
+  return cobsMaxEncodedSize(FRAME_HEADER_SIZE + payloadSize + FRAME_CRC_SIZE) +
+         2;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+ * @param crc The CRC of the preceding bytes, to process data in pieces.
+ */
+uint16_t crc16(const uint8_t* data, size_t size, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief COBS-encodes `size` bytes. No delimiter is added.
+ * @param out At least cobsMaxEncodedSize(size) bytes.
+ * @return Encoded size.
+ */
+size_t cobsEncode(const uint8_t* data, size_t size, uint8_t* out);
+
+/**
+ * @brief Decodes a COBS block without its delimiter.
+ * @param out At least `size` bytes; may be the same buffer as `data`.
+ * @return Decoded size, or 0 if the block is malformed.
+ */
+size_t cobsDecode(const uint8_t* data, size_t size, uint8_t* out);
+
+/**
+ * @brief Builds a complete frame, delimiters included.
+ * @param out At least serialFrameSize(size) bytes.
+ * @return Bytes to transmit.
+ */
+size_t encodeFrame(
+    uint8_t type,
+    uint8_t sequence,
+    const void* payload,
+    size_t size,
+    uint8_t* out
+);
+
+/**
+ * @brief Result of FrameDecoder::push().
+ */
+enum class DecodeResult {
+  NONE,   // Quadro incompleto
+  FRAME,  // Quadro válido disponível
+  TEXT,   // Trecho de texto (logs) entre quadros
+  ERROR,  // Quadro corrompido ou longo demais, descartado
+};
+
+/**
+ * @class FrameDecoder
+ * @brief Incremental frame decoder with a fixed buffer.
+ *
+ * Bytes are pushed one at a time; a delimiter completes the pending block,
+ * which is either a valid frame, printable text (the device logs) or an
+ * error. Blocks longer than the largest frame are discarded, except text,
+ * which is passed on in pieces.
+ *
+ * @tparam MaxPayload Largest payload accepted.
+ */
+template <size_t MaxPayload>
+class FrameDecoder {
+ public:
+  DecodeResult push(uint8_t byte) {
+    if (byte != 0) {
+      if (length < sizeof(encoded)) {
+        encoded[length++] = byte;
+        return DecodeResult::NONE;
+      }
+      // Maior que qualquer quadro: texto é repassado em pedaços, o resto
+      // é descartado até o próximo delimitador
+      DecodeResult result = DecodeResult::NONE;
+      if (!discarding && isText(encoded, length)) {
+        textSize = length;
+        memcpy(textBuffer, encoded, length);
+        result = DecodeResult::TEXT;
+      } else if (!discarding) {
+        discarding = true;
+        errors++;
+        result = DecodeResult::ERROR;
+      }
+      length = 0;
+      encoded[length++] = byte;
+      return result;
+    }
+
+    size_t size = length;
+    length = 0;
+    if (discarding) {
+      discarding = false;
+      return DecodeResult::NONE;
+    }
+    if (size == 0) {
+      return DecodeResult::NONE;
+    }
+
+    size_t decodedSize = cobsDecode(encoded, size, decoded);
+    if (decodedSize >= FRAME_HEADER_SIZE + FRAME_CRC_SIZE) {
+      size_t covered = decodedSize - FRAME_CRC_SIZE;
+      uint16_t expected = decoded[covered] | (decoded[covered + 1] << 8);
+      if (crc16(decoded, covered) == expected) {
+        frameSize = decodedSize;
+        frames++;
+        return DecodeResult::FRAME;
+      }
+    }
+    if (isText(encoded, size)) {
+      textSize = size;
+      memcpy(textBuffer, encoded, size);
+      return DecodeResult::TEXT;
+    }
+    errors++;
+    return DecodeResult::ERROR;
+  }
+
+  uint8_t type() const { return decoded[0]; }
+  uint8_t sequence() const { return decoded[1]; }
+  const uint8_t* payload() const { return decoded + FRAME_HEADER_SIZE; }
+  size_t payloadSize() const {
+    return frameSize - FRAME_HEADER_SIZE - FRAME_CRC_SIZE;
+  }
+
+  const char* text() const { return reinterpret_cast<const char*>(textBuffer); }
+  size_t textLength() const { return textSize; }
+
+  uint32_t framesDecoded() const { return frames; }
+  uint32_t decodeErrors() const { return errors; }
+
+ private:
+  static constexpr size_t MAX_ENCODED =
+      cobsMaxEncodedSize(FRAME_HEADER_SIZE + MaxPayload + FRAME_CRC_SIZE);
+
+  uint8_t encoded[MAX_ENCODED];
+  uint8_t decoded[MAX_ENCODED];
+  uint8_t textBuffer[MAX_ENCODED];
+  size_t length = 0;
+  size_t frameSize = 0;
+  size_t textSize = 0;
+  bool discarding = false;
+  uint32_t frames = 0;
+  uint32_t errors = 0;
+
+  static bool isText(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      uint8_t c = data[i];
+      if ((c < 0x20 || c > 0x7E) && c != '\n' && c != '\r' && c != '\t') {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+#endif  // SERIAL_PROTOCOL_H
@@ -9,16 +9,30 @@ WaveGenerator::WaveGenerator(
 )
     : frequenciesHz(frequenciesHz),
       ad9833(dataPin, clockPin, frameSyncPin),
-      activeChannel(MD_AD9833::CHAN_0)  // Começa com o canal 0
-{ }
+      activeChannel(MD_AD9833::CHAN_0),  // Começa com o canal 0
+      poweredDown(false) { }
 
 void WaveGenerator::init() {
   ad9833.begin();
   ad9833.setMode(MD_AD9833::MODE_SINE);
 }
 
+void WaveGenerator::powerDown() {
+  ad9833.setMode(MD_AD9833::MODE_OFF);
+  poweredDown = true;
+}
+
+void WaveGenerator::powerUp() {
+  ad9833.setMode(MD_AD9833::MODE_SINE);
+  poweredDown = false;
+}
+
 // NOVO: Implementação do método setFrequency que faltava
 void WaveGenerator::setFrequency(long frequency) {
+  if (poweredDown) {
+    powerUp();
+  }
+
   // Determina qual canal está inativo para programar a nova frequência
   MD_AD9833::channel_t inactiveChannel = (activeChannel == MD_AD9833::CHAN_0)
                                              ? MD_AD9833::CHAN_1
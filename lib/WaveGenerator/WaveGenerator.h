@@ -32,8 +32,21 @@ class WaveGenerator {
    */
   void init();
 
+  /**
+   * @brief Turns the output off (AD9833 in reset with DAC and clock
+   * disabled) to save power between cycles. The frequency registers are
+   * kept.
+   */
+  void powerDown();
+
+  /**
+   * @brief Turns the sine output back on at the last frequency.
+   */
+  void powerUp();
+
   /**
    * @brief Sets the output frequency based on a direct frequency value.
+   * Powers the output up if it was off.
    * This method uses both frequency registers for a fast and smooth transition.
    * @param frequency The frequency in Hz to set.
    */
@@ -63,6 +76,7 @@ class WaveGenerator {
   MD_AD9833 ad9833;
   const std::vector<long> frequenciesHz;
   MD_AD9833::channel_t activeChannel;
+  bool poweredDown;
 
   /**
    * @brief Checks if a frequency index is valid.
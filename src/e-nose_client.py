@@ -5,22 +5,41 @@ from datetime import datetime
 from bleak import BleakClient, BleakScanner
 import struct
 import os
+import socket
+import csv
 
 # --- Configurações do Dispositivo e Serviço ---
 # ATUALIZADO: O nome do dispositivo foi alterado no ESP32
 DEVICE_NAME = "E-Nose_V2_LockIn"
 SERVICE_UUID = "bea5692f-939d-4e5a-bfa9-80d3efb8e3cb"
 CHARACTERISTIC_UUID = "b13493c7-5499-4b0a-a3d9-66eea53f382c"
+CLASSIFICATION_CHARACTERISTIC_UUID = "5c1e0a7d-2f43-4b8e-9d61-3a7f0e9b2c14"
+MONITOR_CHARACTERISTIC_UUID = "8d2b6f41-7c3e-4a90-b5d8-1e6f2a9c0b37"
+CONTROL_CHARACTERISTIC_UUID = "e4a7c2d9-5b18-4f63-a0e2-9c7d3b8f1a56"
+COMPENSATED_CHARACTERISTIC_UUID = "3f9a1c6e-84d2-4b57-a1e3-6c0d8b2f7e95"
+LINK_STATS_CHARACTERISTIC_UUID = "a6d0e5b3-19c4-4f7a-8e25-b7c1d93f4a08"
+
+# BLELinkStats: mtu, connected, congested, notifications, bytes_sent,
+# notify_failures, dropped_packets, congestion_events, bytes_per_second
+LINK_STATS_FORMAT = '<HBB5If'
+LINK_STATS_INTERVAL_S = 10
+
+# Classes do classificador embarcado (mesma ordem de OdorModel::CLASS_NAMES)
+CLASS_NAMES = ["empty", "negative", "positive"]
+# OdorClassification: sequence do DataPacket, classe, confiança (0..255)
+CLASSIFICATION_FORMAT = '<IBB'
+CLASSIFICATION_SIZE = struct.calcsize(CLASSIFICATION_FORMAT)
 
 # --- Configuração da Estrutura de Dados (DEVE CORRESPONDER AO ESP32) ---
 NUM_FREQUENCIAS = 6
 NUM_CANAIS = 4
 ADC_DATA_POINTS = NUM_FREQUENCIAS * NUM_CANAIS
 
-# ATUALIZADO: A nova estrutura de dados consiste em:
-# 10 floats (sensores comerciais) + 16 floats (adc_mean) + 16 floats (adc_std_dev) = 42 floats
+# A estrutura de dados consiste em um cabeçalho de 2 uint32 (sequence,
+# timestamp_ms) seguido de 10 floats (sensores comerciais) +
+# ADC_DATA_POINTS floats (adc_mean) + ADC_DATA_POINTS floats (adc_std_dev)
 NUM_FLOATS = 10 + (2 * ADC_DATA_POINTS)
-DATA_FORMAT_STRING = f'<{NUM_FLOATS}f'
+DATA_FORMAT_STRING = f'<2I{NUM_FLOATS}f'
 EXPECTED_DATA_SIZE = struct.calcsize(DATA_FORMAT_STRING) # Calcula o tamanho esperado em bytes
 
 # --- Geração dos Nomes das Colunas para o CSV ---
@@ -29,7 +48,7 @@ FREQUENCIES_HZ = [100, 1000, 5000, 10000, 50000, 100000]
 
 # Colunas fixas
 COLUMN_NAMES = [
-    'Timestamp', 'BME_Temp', 'BME_Hum', 'BME_Pres', 'BME_Gas',
+    'Timestamp', 'Sequence', 'Device_ms', 'BME_Temp', 'BME_Hum', 'BME_Pres', 'BME_Gas',
     'SHT_Temp', 'SHT_Hum', 'MQ3', 'MQ135', 'MQ136', 'MQ137'
 ]
 
@@ -50,36 +69,131 @@ std_dev_columns = [col for col in adc_columns if 'StdDev' in col]
 # Junta tudo na ordem correta
 COLUMN_NAMES.extend(mean_columns + std_dev_columns)
 
+# --- Features corrigidas de deriva (CompensatedFeatures) ---
+# sequence, gated_mask e uma média corrigida por ponto, na ordem de adc_mean
+COMPENSATED_FORMAT_STRING = f'<2I{ADC_DATA_POINTS}f'
+COMPENSATED_DATA_SIZE = struct.calcsize(COMPENSATED_FORMAT_STRING)
+COMPENSATED_COLUMN_NAMES = ['Timestamp', 'Sequence', 'Gated_Mask'] + [
+    col.replace('_Mean', '_Corrected') for col in mean_columns]
+
+# --- Modo de monitoramento contínuo (MonitorCommand / MonitorBatch) ---
+MODE_SWEEP = 0
+MODE_MONITOR = 1
+MAX_MONITOR_POINTS = 8
+MONITOR_COMMAND_FORMAT = f'<BBH{MAX_MONITOR_POINTS}s'
+MONITOR_BATCH_HEADER_FORMAT = '<IB'   # sequence, count
+MONITOR_SAMPLE_FORMAT = '<IBff'       # timestamp_us, point, amplitude, phase
+MONITOR_BATCH_HEADER_SIZE = struct.calcsize(MONITOR_BATCH_HEADER_FORMAT)
+MONITOR_SAMPLE_SIZE = struct.calcsize(MONITOR_SAMPLE_FORMAT)
+MONITOR_COLUMN_NAMES = ['Timestamp', 'Batch', 'Device_us', 'Point', 'Frequency_Hz', 'Channel', 'Amplitude', 'Phase']
+
+# --- Enquadramento do --forward (mesmo formato de lib/SerialProtocol) ---
+# [tipo][sequência][payload][CRC-16] codificado em COBS entre delimitadores
+# 0x00: o receptor descarta um quadro corrompido e se ressincroniza no
+# próximo, em vez de desalinhar todos os pacotes seguintes
+FRAME_DATA_PACKET = 0x01
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, como crc16() do firmware."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    """Codifica em COBS, sem o delimitador."""
+    out = bytearray([0])
+    code_index = 0
+    for byte in data:
+        if byte != 0:
+            out.append(byte)
+        if byte == 0 or len(out) - code_index == 0xFF:
+            out[code_index] = len(out) - code_index
+            code_index = len(out)
+            out.append(0)
+    out[code_index] = len(out) - code_index
+    return bytes(out)
+
+
+def encode_frame(frame_type, sequence, payload):
+    """Monta um quadro completo, com os dois delimitadores."""
+    body = bytes([frame_type, sequence & 0xFF]) + bytes(payload)
+    crc = crc16(body)
+    return b'\x00' + cobs_encode(body + struct.pack('<H', crc)) + b'\x00'
+
+
+def prepare_csv(path, columns):
+    """
+    Cria o CSV com o cabeçalho ou, se ele já existir, confere que o cabeçalho
+    é o atual: anexar linhas de outro layout (ex.: antes de Sequence e
+    Device_ms) deslocaria as colunas sem nenhum aviso.
+    """
+    if not os.path.exists(path) or os.path.getsize(path) == 0:
+        with open(path, 'w', newline='') as f:
+            csv.writer(f).writerow(columns)
+        print(f"Created new CSV file: {path}")
+        return
+    with open(path, newline='') as f:
+        header = next(csv.reader(f), [])
+    if header != columns:
+        raise SystemExit(
+            f"Existing file {path} has a different column layout; "
+            f"choose another output name (-o) instead of appending to it.")
+    print(f"Appending to existing CSV file: {path}")
+
+
+def parse_point(text):
+    """
+    Converte um ponto do formato FREQ:CANAL (ex.: 1000:2) ou de um índice em
+    adc_mean para o índice usado pelo firmware.
+    """
+    if ':' in text:
+        freq, ch = text.split(':')
+        return FREQUENCIES_HZ.index(int(freq)) * NUM_CANAIS + int(ch) - 1
+    return int(text)
+
+
+def build_monitor_command(points, baseline_s):
+    """Monta o MonitorCommand escrito na característica de controle."""
+    if not points:
+        return struct.pack(MONITOR_COMMAND_FORMAT, MODE_SWEEP, 0, 0, b'')
+    return struct.pack(MONITOR_COMMAND_FORMAT, MODE_MONITOR, len(points), baseline_s, bytes(points))
+
 
 def notification_handler(sender, data: bytearray):
     """
     Callback executado toda vez que uma notificação BLE é recebida.
     Desempacota os dados, cria uma linha no DataFrame e anexa ao CSV.
+    Uma notificação pode trazer vários pacotes seguidos quando o MTU permite.
     """
     global output_csv_path
 
     # Verifica se o tamanho dos dados recebidos corresponde ao esperado
-    if len(data) != EXPECTED_DATA_SIZE:
-        print(f"Error: Received {len(data)} bytes, but expected {EXPECTED_DATA_SIZE}. Skipping packet.")
+    if len(data) == 0 or len(data) % EXPECTED_DATA_SIZE != 0:
+        print(f"Error: Received {len(data)} bytes, but expected a multiple of {EXPECTED_DATA_SIZE}. Skipping notification.")
         return
 
     try:
-        # 1. Desempacota os bytes recebidos usando a string de formato
-        unpacked_data = struct.unpack(DATA_FORMAT_STRING, data)
-
-        # 2. Adiciona um timestamp ao início dos dados
+        # 1. Desempacota cada pacote usando a string de formato
         timestamp = datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')
-        full_data_row = [timestamp] + list(unpacked_data)
+        rows = []
+        for unpacked_data in struct.iter_unpack(DATA_FORMAT_STRING, data):
+            # 2. Adiciona um timestamp ao início dos dados
+            rows.append([timestamp] + list(unpacked_data))
 
-        # 3. Cria um DataFrame de uma única linha com os dados
-        df_new_row = pd.DataFrame([full_data_row], columns=COLUMN_NAMES)
+        # 3. Cria um DataFrame com uma linha por pacote
+        df_new_rows = pd.DataFrame(rows, columns=COLUMN_NAMES)
 
         # Exibe um resumo dos dados recebidos para feedback
-        first_adc_mean = unpacked_data[10] # O primeiro valor de 'adc_mean'
-        print(f"Received data packet at {timestamp}. First ADC Mean: {first_adc_mean:.4f}")
+        first_adc_mean = rows[-1][13] # O primeiro valor de 'adc_mean'
+        print(f"Received {len(rows)} data packet(s) at {timestamp}. First ADC Mean: {first_adc_mean:.4f}")
 
         # 4. Anexa ao arquivo CSV
-        df_new_row.to_csv(output_csv_path, mode='a', header=False, index=False)
+        df_new_rows.to_csv(output_csv_path, mode='a', header=False, index=False)
 
     except struct.error as e:
         print(f"Error unpacking data: {e}. Received {len(data)} bytes.")
@@ -87,19 +201,126 @@ def notification_handler(sender, data: bytearray):
         print(f"An error occurred in notification_handler: {e}")
 
 
+def forward_handler(sender, data: bytearray):
+    """
+    Callback usado com --forward: repassa cada pacote da notificação, em um
+    quadro próprio, ao receptor nativo (tools/receiver), que faz o
+    desempacotamento, o carimbo de tempo e a escrita em lote.
+    """
+    if len(data) == 0 or len(data) % EXPECTED_DATA_SIZE != 0:
+        print(f"Error: Received {len(data)} bytes, but expected a multiple of {EXPECTED_DATA_SIZE}. Skipping notification.")
+        return
+    frames = bytearray()
+    for offset in range(0, len(data), EXPECTED_DATA_SIZE):
+        packet = data[offset:offset + EXPECTED_DATA_SIZE]
+        sequence = struct.unpack_from('<I', packet)[0]
+        frames += encode_frame(FRAME_DATA_PACKET, sequence, packet)
+    try:
+        forward_socket.sendall(frames)
+    except OSError as e:
+        print(f"Error forwarding packet: {e}")
+
+
+def classification_handler(sender, data: bytearray):
+    """
+    Callback da característica de classificação: o Sequence do pacote
+    classificado, 1 byte de classe e 1 byte de confiança (0..255).
+    """
+    if len(data) != CLASSIFICATION_SIZE:
+        print(f"Invalid classification payload: {len(data)} bytes.")
+        return
+    sequence, label, confidence = struct.unpack(CLASSIFICATION_FORMAT, data)
+    name = CLASS_NAMES[label] if label < len(CLASS_NAMES) else f"class {label}"
+    print(f"Device classification of packet {sequence}: {name} ({confidence / 255.0:.0%} confidence)")
+
+
+def compensated_handler(sender, data: bytearray):
+    """
+    Callback da característica de compensação de deriva: médias do lock-in
+    menos a linha de base prevista pela temperatura/umidade, anexadas ao CSV
+    de features corrigidas. O Sequence casa com o pacote bruto.
+    """
+    if len(data) != COMPENSATED_DATA_SIZE:
+        print(f"Error: Received {len(data)} compensated bytes, but expected {COMPENSATED_DATA_SIZE}. Skipping.")
+        return
+    values = struct.unpack(COMPENSATED_FORMAT_STRING, data)
+    if compensated_csv_path is not None:
+        timestamp = datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')
+        with open(compensated_csv_path, 'a', newline='') as f:
+            csv.writer(f).writerow([timestamp] + list(values))
+    gated = bin(values[1]).count('1')
+    if gated:
+        print(f"Drift compensation: {gated} point(s) away from baseline")
+
+
+def monitor_handler(sender, data: bytearray):
+    """
+    Callback da característica de monitoramento: um MonitorBatch com `count`
+    amostras (amplitude/fase de janela deslizante) anexadas ao CSV de
+    monitoramento.
+    """
+    if len(data) < MONITOR_BATCH_HEADER_SIZE:
+        print(f"Invalid monitor payload: {len(data)} bytes.")
+        return
+    sequence, count = struct.unpack_from(MONITOR_BATCH_HEADER_FORMAT, data)
+    if len(data) != MONITOR_BATCH_HEADER_SIZE + count * MONITOR_SAMPLE_SIZE:
+        print(f"Error: Monitor batch of {len(data)} bytes does not hold {count} samples. Skipping batch.")
+        return
+
+    timestamp = datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')
+    rows = []
+    for i in range(count):
+        device_us, point, amplitude, phase = struct.unpack_from(
+            MONITOR_SAMPLE_FORMAT, data, MONITOR_BATCH_HEADER_SIZE + i * MONITOR_SAMPLE_SIZE)
+        rows.append([timestamp, sequence, device_us, point,
+                     FREQUENCIES_HZ[point // NUM_CANAIS], point % NUM_CANAIS + 1, amplitude, phase])
+    with open(monitor_csv_path, 'a', newline='') as f:
+        csv.writer(f).writerows(rows)
+
+
+async def print_link_stats(client: BleakClient):
+    """Lê e exibe os contadores do enlace BLE mantidos pelo dispositivo."""
+    try:
+        raw = await client.read_gatt_char(LINK_STATS_CHARACTERISTIC_UUID)
+        (mtu, _, congested, notifications, bytes_sent, failures,
+         dropped, congestion_events, bytes_per_second) = struct.unpack(LINK_STATS_FORMAT, raw)
+        print(f"Link: MTU {mtu}, {bytes_per_second:.0f} B/s, {notifications} notifications, "
+              f"{dropped} dropped, {failures} failures, {congestion_events} congestion events")
+    except Exception as e:
+        print(f"Could not read link stats: {e}")
+
+
 async def main(args):
     """
     Função principal assíncrona.
     Procura pelo dispositivo, conecta, ativa notificações e gerencia reconexões.
     """
-    global output_csv_path
+    global output_csv_path, forward_socket, monitor_csv_path, compensated_csv_path
     output_csv_path = args.output
+    data_handler = notification_handler
+
+    monitor_points = [parse_point(p) for p in args.monitor.split(',')] if args.monitor else []
+    if len(monitor_points) > MAX_MONITOR_POINTS:
+        raise SystemExit(f"At most {MAX_MONITOR_POINTS} monitor points are supported.")
+    monitor_command = build_monitor_command(monitor_points, args.baseline_s)
+    monitor_csv_path = os.path.splitext(output_csv_path)[0] + '_monitor.csv'
+    if monitor_points:
+        prepare_csv(monitor_csv_path, MONITOR_COLUMN_NAMES)
 
-    if not os.path.exists(output_csv_path):
-        pd.DataFrame(columns=COLUMN_NAMES).to_csv(output_csv_path, index=False)
-        print(f"Created new CSV file: {output_csv_path}")
+    if args.forward:
+        forward_socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        forward_socket.connect(args.forward)
+        data_handler = forward_handler
+        print(f"Forwarding packets to {args.forward}")
     else:
-        print(f"Appending to existing CSV file: {output_csv_path}")
+        prepare_csv(output_csv_path, COLUMN_NAMES)
+
+    # As features corrigidas acompanham o CSV bruto; com --forward nada é
+    # escrito localmente
+    compensated_csv_path = None
+    if not args.forward:
+        compensated_csv_path = os.path.splitext(output_csv_path)[0] + '_corrected.csv'
+        prepare_csv(compensated_csv_path, COMPENSATED_COLUMN_NAMES)
 
     def handle_disconnect(client: BleakClient):
         print(f"Device {client.address} disconnected. Attempting to reconnect...")
@@ -120,11 +341,19 @@ async def main(args):
             async with BleakClient(device, disconnected_callback=handle_disconnect) as client:
                 if client.is_connected:
                     print("Connected successfully!")
-                    await client.start_notify(CHARACTERISTIC_UUID, notification_handler)
+                    await client.start_notify(CHARACTERISTIC_UUID, data_handler)
+                    await client.start_notify(CLASSIFICATION_CHARACTERISTIC_UUID, classification_handler)
+                    await client.start_notify(COMPENSATED_CHARACTERISTIC_UUID, compensated_handler)
+                    if monitor_points:
+                        await client.start_notify(MONITOR_CHARACTERISTIC_UUID, monitor_handler)
+                    # Sempre escrito: sem --monitor, garante a volta à varredura
+                    await client.write_gatt_char(CONTROL_CHARACTERISTIC_UUID, monitor_command, response=True)
                     print("Notifications started. Waiting for data... (Press Ctrl+C to stop)")
 
                     while client.is_connected:
-                        await asyncio.sleep(1)
+                        await asyncio.sleep(LINK_STATS_INTERVAL_S)
+                        if client.is_connected:
+                            await print_link_stats(client)
 
         except Exception as e:
             print(f"An error occurred: {e}. Cleaning up and retrying in 5 seconds...")
@@ -141,6 +370,24 @@ if __name__ == "__main__":
         default=default_filename,
         help=f"Output CSV file name. Default: {default_filename}"
     )
+    parser.add_argument(
+        "--forward",
+        type=str,
+        default=None,
+        help="UNIX socket of a native receiver (tools/receiver); packets are relayed in serial-link frames instead of written to CSV."
+    )
+    parser.add_argument(
+        "--monitor",
+        type=str,
+        default=None,
+        help="Comma-separated points to stream continuously, as FREQ:CHANNEL (e.g. 1000:2) or adc_mean indices. Samples go to <output>_monitor.csv."
+    )
+    parser.add_argument(
+        "--baseline-s",
+        type=int,
+        default=300,
+        help="With --monitor, run a full sweep every N seconds for baseline updates (0 = never). Default: 300"
+    )
     args = parser.parse_args()
 
     try:
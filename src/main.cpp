@@ -1,14 +1,21 @@
 #include <Arduino.h>
+#include <esp_timer.h>
 
+#include <algorithm>
+#include <iterator>
 #include <vector>
 
 #include "BLEManager.h"
 #include "BME680_Sensor.h"
+#include "CycleScheduler.h"
+#include "DriftCompensator.h"
 #include "ENoseController.h"
 #include "LTC2310.h"
 #include "Multiplexer.h"
+#include "OdorClassifier.h"
 #include "SHT31_Sensor.h"
 #include "SensorData.h"  // Contém a nova DataPacket e definições
+#include "SerialLink.h"
 #include "WaveGenerator.h"
 
 // --- Definições de Pinos ---
@@ -32,32 +39,131 @@ const int WAVE_SETTLING_TIME_US =
 const int READINGS_PER_POINT = 20;  // N leituras para calcular média/std_dev
 const int SAMPLES_PER_READING =
     1024;  // Amostras do ADC por leitura de amplitude
-const int CYCLE_DELAY_MS =
-    1000;  // Delay adicional ao final de um ciclo completo
+// Período entre inícios de ciclo. Só há economia se for maior que a
+// varredura (~22 s): com um período menor os ciclos emendam e nada entra em
+// baixo consumo
+const int CYCLE_DELAY_MS = 60000;
 
-// Lista de freq1024uências a serem varridas
-const std::initializer_list<long> FREQUENCIES_HZ = {
-    100, 1000, 5000, 10000, 50000, 100000
-};
-const int NUM_MUX_CHANNELS = 4;  // Definido em SensorData.h também
+// --- Constantes do escalonador (ciclo de trabalho) ---
+const int IDLE_CPU_FREQ_MHZ =
+    80;  // Menor frequência que mantém o BLE (APB continua em 80 MHz)
+const int MIN_LOW_POWER_MS =
+    20;  // Intervalos menores esperam sem desligar nada
+const int INITIAL_WARMUP_MS = 5;      // Refinado com o warm-up medido
+const int DEADLINE_TOLERANCE_MS = 5;  // Atraso aceito no início do ciclo
+const int SCHEDULER_REPORT_CYCLES = 10;
+
+// --- Constantes do modo de monitoramento contínuo ---
+// Um resultado a cada segmento; a janela cobre
+// ENoseController::MONITOR_WINDOW_SEGMENTS segmentos sobrepostos. O segmento
+// é arredondado para períodos inteiros da referência: 1 ms (100 períodos) a
+// 100 kHz, 10 ms (1 período, janela de 40 ms) a 100 Hz
+const uint32_t MONITOR_MIN_SEGMENT_US = 1000;
+const int MONITOR_POINT_DWELL_MS =
+    250;  // Permanência em cada ponto quando há mais de um
+const int MONITOR_BATCH_MAX_AGE_MS =
+    100;  // Latência máxima de um lote incompleto
+
+// --- Captura de amostras brutas (enviadas pela serial) ---
+const int RAW_QUEUE_TIMEOUT_MS =
+    500;  // Espera pela transferência antes de descartar um bloco
+
+// A lista de frequências e o número de canais vêm de ActiveScan
+// (SensorData.h); os pinos do multiplexer precisam acompanhar o número de
+// canais
+constexpr int MUX_PINS[] = {27, 25, 26, 13};
+static_assert(
+    sizeof(MUX_PINS) / sizeof(MUX_PINS[0]) == ActiveScan::NUM_CHANNELS,
+    "One multiplexer pin is required per scanned channel"
+);
 
 // Data Queue
 #define DATA_QUEUE_LENGTH 5
+#define MONITOR_QUEUE_LENGTH 4
+#define RAW_QUEUE_LENGTH 2  // Cada bloco ocupa ~2 KB
+// DataPackets que cabem em uma notificação com o maior MTU
+constexpr size_t MAX_COALESCED_PACKETS =
+    BLE_MAX_ATTRIBUTE_SIZE / sizeof(DataPacket);
+const unsigned long LINK_STATS_INTERVAL_MS = 10000;
+const unsigned MIN_FREE_STACK_BYTES = 1024;  // Aviso de pilha quase cheia
 QueueHandle_t dataQueue;
+QueueHandle_t classificationQueue;
+QueueHandle_t compensationQueue;
+QueueHandle_t monitorQueue;
+QueueHandle_t rawQueue;
+QueueHandle_t commandQueue;
 
 // --- Instâncias dos Objetos ---
 SPIClass hspi(HSPI);
 WaveGenerator waveGenerator(
-    FREQUENCIES_HZ, WAVEGEN_DATA_PIN, WAVEGEN_CLOCK_PIN, WAVEGEN_FSYNC_PIN
+    std::vector<long>(
+        std::begin(ActiveScan::FREQUENCIES_HZ),
+        std::end(ActiveScan::FREQUENCIES_HZ)
+    ),
+    WAVEGEN_DATA_PIN,
+    WAVEGEN_CLOCK_PIN,
+    WAVEGEN_FSYNC_PIN
 );
-Multiplexer multiplexer({27, 25, 26, 13});  // Exemplo com 4 canais
+Multiplexer multiplexer(MUX_PINS);
 LTC2310 adc(LTC2310_CS_PIN, hspi);
 BME680_Sensor bmeSensor;
 SHT31_Sensor sht31Sensor;
 ENoseController controller(
     waveGenerator, multiplexer, adc, WAVE_SETTLING_TIME_US
 );
+OdorClassifier classifier;
+DriftCompensator driftCompensator;
 BLEManager bleManager("E-Nose_V2_LockIn");
+SerialLink serialLink(Serial);
+
+// Enlaces que recebem tudo o que é produzido
+PacketTransport *const transports[] = {&bleManager, &serialLink};
+
+/**
+ * @brief Plataforma do escalonador no ESP32: esp_timer como base de tempo,
+ * espera bloqueada na fila de comandos (um comando encerra a espera) e CPU
+ * em IDLE_CPU_FREQ_MHZ nos intervalos longos.
+ */
+class FirmwareSchedulerPlatform : public SchedulerPlatform {
+ public:
+  uint64_t nowUs() override { return esp_timer_get_time(); }
+
+  bool idleUntilUs(uint64_t deadlineUs, bool lowPower) override {
+    uint32_t normalMhz = getCpuFrequencyMhz();
+    if (lowPower) {
+      setCpuFrequencyMhz(IDLE_CPU_FREQ_MHZ);
+    }
+
+    // Peek: o comando fica na fila para o laço principal
+    bool completed = true;
+    MonitorCommand pending;
+    uint64_t now = nowUs();
+    if (deadlineUs > now + 1000) {
+      uint32_t remainingMs = (deadlineUs - now) / 1000;
+      TickType_t ticks = pdMS_TO_TICKS(remainingMs);
+      completed = xQueuePeek(commandQueue, &pending, ticks) != pdPASS;
+    }
+    // Resto menor que um tick
+    while (completed && nowUs() < deadlineUs) { }
+
+    if (lowPower) {
+      setCpuFrequencyMhz(normalMhz);
+    }
+    return completed;
+  }
+
+  void powerDownPeripherals() override { controller.powerDown(); }
+  void powerUpPeripherals() override { controller.powerUp(); }
+};
+
+FirmwareSchedulerPlatform schedulerPlatform;
+CycleScheduler scheduler(
+    schedulerPlatform,
+    {CYCLE_DELAY_MS * 1000UL,
+     MIN_LOW_POWER_MS * 1000UL,
+     INITIAL_WARMUP_MS * 1000UL,
+     DEADLINE_TOLERANCE_MS * 1000UL}
+);
 
 TaskHandle_t sensorReaderTaskHandle;
 TaskHandle_t dataTransferTaskHandle;
@@ -70,6 +176,256 @@ float readMqSensorVoltage(int pin) {
   return (float) rawValue / ADC_RESOLUTION * MQ_ADC_VREF;
 }
 
+/**
+ * @brief Executa uma varredura completa e enfileira o pacote e a
+ * classificação resultantes.
+ */
+void runSweepCycle(uint32_t &sequence, unsigned long cycleStartTime) {
+  DataPacket packet;
+  packet.sequence = sequence++;
+  packet.timestamp_ms = cycleStartTime;
+
+  // 1. Ler todos os sensores comerciais (lentos) uma vez por ciclo
+  BME680_Data bmeData;
+  SHT31_Data sht31Data;
+  bmeSensor.readSensor(bmeData);
+  sht31Sensor.readSensor(sht31Data);
+
+  packet.bme_temperature = bmeData.temperature;
+  packet.bme_humidity = bmeData.humidity;
+  packet.bme_pressure = bmeData.pressure;
+  packet.bme_gas_resistance = bmeData.gas_resistance;
+  packet.sht_temperature = sht31Data.temperature;
+  packet.sht_humidity = sht31Data.humidity;
+  packet.mq3_value = readMqSensorVoltage(MQ3_PIN);
+  packet.mq135_value = readMqSensorVoltage(MQ135_PIN);
+  packet.mq136_value = readMqSensorVoltage(MQ136_PIN);
+  packet.mq137_value = readMqSensorVoltage(MQ137_PIN);
+
+  // 2. Varre todas as frequências e canais para o sensor fabricado.
+  // O laço é expandido em tempo de compilação: frequência, canal e índice
+  // no pacote são constantes em cada ponto.
+  ActiveScan::forEachPoint([&](auto point) {
+    using Point = decltype(point);
+    // channel settling time
+    // delayMicroseconds(1000000);
+    // delayMicroseconds(500000);
+    // wait 5 seconds to channel stabilization
+    vTaskDelay(pdMS_TO_TICKS(50));
+    Serial.printf(
+        "Measuring Freq %ld Hz, Channel %d...\n",
+        Point::FREQUENCY_HZ,
+        Point::CHANNEL
+    );
+
+    LockInResult result = controller.performLockInMeasurement(
+        Point::FREQUENCY_HZ,
+        Point::CHANNEL,
+        READINGS_PER_POINT,
+        SAMPLES_PER_READING
+    );
+
+    packet.adc_mean[Point::INDEX] = result.mean;
+    packet.adc_std_dev[Point::INDEX] = result.std_dev;
+    Serial.printf(
+        "   -> Mean: %.4f V, StdDev: %.4f V\n", result.mean, result.std_dev
+    );
+  });
+
+  // 3. Classificar o ciclo no próprio dispositivo (só com um modelo que
+  // passou no critério de acurácia do treinador). Classificação e
+  // compensação levam o sequence do pacote: se o envio do pacote falhar,
+  // a tarefa de transferência as descarta em vez de pareá-las com o
+  // próximo
+  if (OdorClassifier::enabled()) {
+    OdorClassification classification = classifier.classify(packet);
+    Serial.printf(
+        "Classification: %s (confidence %u/255)\n",
+        OdorClassifier::labelName(classification.label),
+        classification.confidence
+    );
+    // Enfileirada antes do pacote para que a tarefa de transferência a
+    // encontre pronta logo depois de enviar o DataPacket correspondente
+    if (xQueueSend(classificationQueue, &classification, 0) != pdPASS) {
+      Serial.println("WARN: Classification queue is full!");
+    }
+  }
+
+  // 4. Remover a deriva de temperatura/umidade da linha de base (também
+  // enfileirada antes do pacote)
+  CompensatedFeatures compensated;
+  if (!driftCompensator.compensate(packet, compensated)) {
+    Serial.println(
+        "WARN: No temperature/humidity reading, baseline not updated"
+    );
+  }
+  if (xQueueSend(compensationQueue, &compensated, 0) != pdPASS) {
+    Serial.println("WARN: Compensation queue is full!");
+  }
+
+  // 5. Enviar o pacote de dados completo para a fila
+  if (xQueueSend(dataQueue, &packet, pdMS_TO_TICKS(100)) != pdPASS) {
+    Serial.println("WARN: Data queue is full!");
+  }
+}
+
+/**
+ * @brief Envia o lote de monitoramento para a fila, se não estiver vazio.
+ */
+void flushMonitorBatch(MonitorBatch &batch) {
+  static uint32_t batchSequence = 0;
+  if (batch.count == 0) {
+    return;
+  }
+  batch.sequence = batchSequence++;
+  if (xQueueSend(monitorQueue, &batch, 0) != pdPASS) {
+    Serial.println("WARN: Monitor queue is full!");
+  }
+  batch.count = 0;
+}
+
+/**
+ * @brief Monitora continuamente os pontos do comando, alternando entre eles.
+ *
+ * @return true se a varredura de linha de base venceu (ou o comando não
+ * tinha pontos válidos); false se um novo comando foi recebido em `command`.
+ */
+bool runMonitoring(MonitorCommand &command) {
+  // Descarta pontos fora da varredura ativa
+  uint8_t numPoints = 0;
+  for (uint8_t i = 0; i < command.num_points; ++i) {
+    if (command.points[i] < ADC_DATA_POINTS) {
+      command.points[numPoints++] = command.points[i];
+    } else {
+      Serial.printf(
+          "WARN: Ignoring invalid monitor point %u\n", command.points[i]
+      );
+    }
+  }
+  command.num_points = numPoints;
+  if (numPoints == 0) {
+    command.mode = MODE_SWEEP;
+    return true;
+  }
+
+  Serial.printf(
+      "Monitoring %u point(s), baseline every %u s\n",
+      numPoints,
+      command.baseline_interval_s
+  );
+
+  const unsigned long baselineMs = command.baseline_interval_s * 1000UL;
+  const unsigned long startMs = millis();
+  unsigned long batchStartMs = startMs;
+  MonitorBatch batch;
+  batch.count = 0;
+
+  for (int current = 0;; current = (current + 1) % numPoints) {
+    uint8_t point = command.points[current];
+    controller.beginMonitoring(
+        ActiveScan::frequencyOfPoint(point),
+        ActiveScan::channelOfPoint(point),
+        MONITOR_MIN_SEGMENT_US
+    );
+
+    // Com um único ponto não há troca (nem reassentamento)
+    unsigned long dwellStartMs = millis();
+    while (numPoints == 1 ||
+           millis() - dwellStartMs < MONITOR_POINT_DWELL_MS) {
+      float amplitude, phase;
+      if (controller.monitorStep(amplitude, phase)) {
+        if (batch.count == 0) {
+          batchStartMs = millis();
+        }
+        MonitorSample &sample = batch.samples[batch.count++];
+        sample.timestamp_us = micros();
+        sample.point = point;
+        sample.amplitude = amplitude;
+        sample.phase = phase;
+      }
+
+      unsigned long now = millis();
+      if (batch.count == MONITOR_BATCH_SIZE ||
+          (batch.count > 0 && now - batchStartMs >= MONITOR_BATCH_MAX_AGE_MS)) {
+        flushMonitorBatch(batch);
+      }
+
+      if (xQueueReceive(commandQueue, &command, 0) == pdPASS) {
+        flushMonitorBatch(batch);
+        return false;
+      }
+      if (baselineMs > 0 && now - startMs >= baselineMs) {
+        flushMonitorBatch(batch);
+        return true;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Captura blocos de amostras brutas em cada ponto do comando e volta
+ * ao modo de varredura. Um novo comando interrompe a captura.
+ */
+void runRawCapture(MonitorCommand &command) {
+  static RawSampleBlock block;  // ~2 KB, fora da pilha da tarefa
+  static uint32_t blockSequence = 0;
+  const uint16_t numBlocks = command.raw_blocks > 0 ? command.raw_blocks : 1;
+  command.mode = MODE_SWEEP;
+
+  for (uint8_t i = 0; i < command.num_points; ++i) {
+    uint8_t point = command.points[i];
+    if (point >= ADC_DATA_POINTS) {
+      Serial.printf("WARN: Ignoring invalid capture point %u\n", point);
+      continue;
+    }
+    Serial.printf("Capturing %u raw block(s) at point %u\n", numBlocks, point);
+    controller.beginRawCapture(
+        ActiveScan::frequencyOfPoint(point), ActiveScan::channelOfPoint(point)
+    );
+
+    for (uint16_t b = 0; b < numBlocks; ++b) {
+      block.sequence = blockSequence++;
+      block.point = point;
+      block.count = RAW_BLOCK_SAMPLES;
+      block.start_us = micros();
+      controller.readRawBlock(block.samples, RAW_BLOCK_SAMPLES);
+      block.duration_us = micros() - block.start_us;
+
+      // Espera a transferência: a serial é mais lenta que o ADC
+      if (xQueueSend(rawQueue, &block, pdMS_TO_TICKS(RAW_QUEUE_TIMEOUT_MS)) !=
+          pdPASS) {
+        Serial.println("WARN: Raw sample queue is full!");
+      }
+      if (uxQueueMessagesWaiting(commandQueue) > 0) {
+        Serial.println("Raw capture interrupted by a new command");
+        return;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Mostra a contabilidade de tempo do escalonador a cada
+ * SCHEDULER_REPORT_CYCLES ciclos.
+ */
+void printSchedulerStats() {
+  const SchedulerStats &stats = scheduler.stats();
+  if (stats.cycles % SCHEDULER_REPORT_CYCLES != 0) {
+    return;
+  }
+  uint64_t total =
+      stats.workUs + stats.lowPowerUs + stats.idleUs + stats.warmUpUs;
+  Serial.printf(
+      "Scheduler: %u cycles, %u missed, %u overruns, low power %.1f%%, "
+      "warm-up %u us\n",
+      (unsigned) stats.cycles,
+      (unsigned) stats.missedDeadlines,
+      (unsigned) stats.overruns,
+      total > 0 ? 100.0 * stats.lowPowerUs / total : 0.0,
+      (unsigned) scheduler.warmUpEstimateUs()
+  );
+}
+
 void sensorReaderTask(void *pvParameters) {
   Serial.print("Sensor Reader Task running on core ");
   Serial.println(xPortGetCoreID());
@@ -77,98 +433,200 @@ void sensorReaderTask(void *pvParameters) {
   hspi.begin(LTC_HSPI_SCK_PIN, LTC_HSPI_MISO_PIN, LTC_HSPI_MOSI_PIN, -1);
   controller.init();
   bmeSensor.init();
-  sht31Sensor.init();
+  if (!sht31Sensor.init()) {
+    // Sem SHT31 a compensação de deriva usa só o BME680
+    driftCompensator.selectSensor(DriftCompensator::SENSOR_BME680);
+  }
   pinMode(MQ3_PIN, INPUT);
   pinMode(MQ135_PIN, INPUT);
   pinMode(MQ136_PIN, INPUT);
   pinMode(MQ137_PIN, INPUT);
 
-  for (;;) {  // Loop principal da tarefa (um ciclo completo por iteração)
-    unsigned long cycleStartTime = millis();
-    DataPacket packet;
-
-    // 1. Ler todos os sensores comerciais (lentos) uma vez por ciclo
-    BME680_Data bmeData;
-    SHT31_Data sht31Data;
-    bmeSensor.readSensor(bmeData);
-    sht31Sensor.readSensor(sht31Data);
-
-    packet.bme_temperature = bmeData.temperature;
-    packet.bme_humidity = bmeData.humidity;
-    packet.bme_pressure = bmeData.pressure;
-    packet.bme_gas_resistance = bmeData.gas_resistance;
-    packet.sht_temperature = sht31Data.temperature;
-    packet.sht_humidity = sht31Data.humidity;
-    packet.mq3_value = readMqSensorVoltage(MQ3_PIN);
-    packet.mq135_value = readMqSensorVoltage(MQ135_PIN);
-    packet.mq136_value = readMqSensorVoltage(MQ136_PIN);
-    packet.mq137_value = readMqSensorVoltage(MQ137_PIN);
-
-    // 2. Varre todas as frequências e canais para o sensor fabricado
-    int data_index = 0;
-    for (long freq : FREQUENCIES_HZ) {
-      for (int ch = 1; ch <= NUM_MUX_CHANNELS; ++ch) {
-        // channel settling time
-        // delayMicroseconds(1000000);
-        // delayMicroseconds(500000);
-        // wait 5 seconds to channel stabilization
-        vTaskDelay(pdMS_TO_TICKS(50));
-        Serial.printf("Measuring Freq %ld Hz, Channel %d...\n", freq, ch);
-
-        LockInResult result = controller.performLockInMeasurement(
-            freq, ch, READINGS_PER_POINT, SAMPLES_PER_READING
-        );
-
-        if (data_index < ADC_DATA_POINTS) {
-          packet.adc_mean[data_index] = result.mean;
-          packet.adc_std_dev[data_index] = result.std_dev;
-          data_index++;
-        }
-        Serial.printf(
-            "   -> Mean: %.4f V, StdDev: %.4f V\n", result.mean, result.std_dev
-        );
+  uint32_t sequence = 0;
+  MonitorCommand command = {};  // Começa no modo de varredura
+  for (;;) {  // Loop principal da tarefa
+    // No modo de monitoramento, a varredura completa só roda quando a linha
+    // de base vence
+    if (command.mode == MODE_RAW_CAPTURE) {
+      runRawCapture(command);
+      scheduler.resync();
+      if (xQueueReceive(commandQueue, &command, 0) == pdPASS) {
+        continue;
       }
     }
-
-    // 3. Enviar o pacote de dados completo para a fila
-    if (xQueueSend(dataQueue, &packet, pdMS_TO_TICKS(100)) != pdPASS) {
-      Serial.println("WARN: Data queue is full!");
+    if (command.mode == MODE_MONITOR) {
+      bool baselineDue = runMonitoring(command);
+      // O tempo em monitoramento não conta como atraso do plano
+      scheduler.resync();
+      if (!baselineDue) {
+        continue;  // Novo comando recebido
+      }
     }
 
+    unsigned long cycleStartTime = millis();
+    scheduler.beginCycle();
+    runSweepCycle(sequence, cycleStartTime);
+
     unsigned long cycleTime = millis() - cycleStartTime;
     Serial.printf("--- Cycle finished in %lu ms ---\n", cycleTime);
 
-    // 4. Aguardar o restante do tempo até o próximo ciclo
-    if (cycleTime < CYCLE_DELAY_MS) {
-      vTaskDelay(pdMS_TO_TICKS(CYCLE_DELAY_MS - cycleTime));
+    // Aguardar o próximo ciclo com os periféricos desligados; um comando
+    // recebido durante a espera é aplicado imediatamente
+    if (command.mode == MODE_SWEEP) {
+      scheduler.waitForNextCycle();
+      printSchedulerStats();
+    }
+    xQueueReceive(commandQueue, &command, 0);
+  }
+}
+
+/**
+ * @brief Retira da fila o resultado (classificação ou compensação) do
+ * pacote `sequence`. Resultados de pacotes anteriores, cujo envio falhou,
+ * são descartados; os de pacotes seguintes ficam na fila.
+ */
+template <typename T>
+bool receiveForPacket(QueueHandle_t queue, uint32_t sequence, T &item) {
+  while (xQueuePeek(queue, &item, 0) == pdPASS) {
+    if ((int32_t) (item.sequence - sequence) > 0) {
+      return false;
+    }
+    xQueueReceive(queue, &item, 0);
+    if (item.sequence == sequence) {
+      return true;
     }
   }
+  return false;
 }
 
 void dataTransferTask(void *pvParameters) {
   Serial.print("Data Transfer Task running on core ");
   Serial.println(xPortGetCoreID());
-  DataPacket receivedPacket;
+  DataPacket receivedPackets[MAX_COALESCED_PACKETS];
+  OdorClassification receivedClassification;
+  CompensatedFeatures receivedCompensated;
+  MonitorBatch receivedBatch;
+  static RawSampleBlock receivedRaw;  // ~2 KB, fora da pilha da tarefa
+  unsigned long lastLinkStatsMs = millis();
   for (;;) {
-    if (xQueueReceive(dataQueue, &receivedPacket, portMAX_DELAY) == pdPASS) {
-      bleManager.sendData(receivedPacket);
+    // Comandos recebidos pela serial
+    for (PacketTransport *transport : transports) {
+      transport->poll();
+    }
+
+    // Timeout curto para que os lotes de monitoramento não esperem por um
+    // DataPacket
+    if (xQueueReceive(dataQueue, &receivedPackets[0], pdMS_TO_TICKS(10)) ==
+        pdPASS) {
+      // Pacotes acumulados (ex.: após congestionamento) seguem juntos; cada
+      // enlace os divide conforme o próprio limite (MTU no BLE)
+      size_t count = 1;
+      while (count < MAX_COALESCED_PACKETS &&
+             xQueueReceive(dataQueue, &receivedPackets[count], 0) == pdPASS) {
+        count++;
+      }
+      for (PacketTransport *transport : transports) {
+        transport->sendData(receivedPackets, count);
+      }
+
+      for (size_t i = 0; i < count; ++i) {
+        uint32_t sequence = receivedPackets[i].sequence;
+        if (receiveForPacket(
+                classificationQueue, sequence, receivedClassification
+            )) {
+          for (PacketTransport *transport : transports) {
+            transport->sendClassification(receivedClassification);
+          }
+        }
+        if (receiveForPacket(
+                compensationQueue, sequence, receivedCompensated
+            )) {
+          for (PacketTransport *transport : transports) {
+            transport->sendCompensatedFeatures(receivedCompensated);
+          }
+        }
+      }
+    }
+    while (xQueueReceive(monitorQueue, &receivedBatch, 0) == pdPASS) {
+      for (PacketTransport *transport : transports) {
+        transport->sendMonitorBatch(receivedBatch);
+      }
+    }
+    // Blocos brutos só passam pela serial (o BLE recusa)
+    while (xQueueReceive(rawQueue, &receivedRaw, 0) == pdPASS) {
+      for (PacketTransport *transport : transports) {
+        transport->sendRawSamples(receivedRaw);
+      }
+    }
+
+    if (millis() - lastLinkStatsMs >= LINK_STATS_INTERVAL_MS) {
+      lastLinkStatsMs = millis();
+      // Menor folga da pilha desde o início (em bytes no ESP32)
+      unsigned stackFree = uxTaskGetStackHighWaterMark(NULL);
+      if (stackFree < MIN_FREE_STACK_BYTES) {
+        Serial.printf(
+            "WARN: Data transfer task stack low, %u bytes free\n", stackFree
+        );
+      }
+      BLELinkStats link = bleManager.getLinkStats();
+      if (link.connected) {
+        Serial.printf(
+            "BLE link: MTU %u, %.0f B/s, %lu notifications, %lu dropped, "
+            "%lu failures, %lu congestion events\n",
+            link.mtu,
+            link.bytes_per_second,
+            (unsigned long) link.notifications,
+            (unsigned long) link.dropped_packets,
+            (unsigned long) link.notify_failures,
+            (unsigned long) link.congestion_events
+        );
+      }
+      if (serialLink.isConnected()) {
+        const SerialLinkStats &serialStats = serialLink.getStats();
+        Serial.printf(
+            "Serial link: %lu frames, %lu bytes sent, %lu received, "
+            "%lu errors\n",
+            (unsigned long) serialStats.framesSent,
+            (unsigned long) serialStats.bytesSent,
+            (unsigned long) serialStats.framesReceived,
+            (unsigned long) serialStats.receiveErrors
+        );
+      }
     }
   }
 }
 
 void setup() {
-  Serial.begin(115200);
+  // Quadros inteiros no buffer de transmissão: write() não espera a UART
+  Serial.setTxBufferSize(serialFrameSize(SERIAL_MAX_PAYLOAD));
+  Serial.begin(SERIAL_LINK_BAUD);
   while (!Serial);  // Aguarda a conexão serial
   Serial.println("Starting E-Nose with Lock-In Amplifier logic...");
+  if (!OdorClassifier::enabled()) {
+    Serial.println("WARN: Odor model is disabled, classification is off");
+  }
 
-  bleManager.init();
   dataQueue = xQueueCreate(DATA_QUEUE_LENGTH, sizeof(DataPacket));
+  classificationQueue =
+      xQueueCreate(DATA_QUEUE_LENGTH, sizeof(OdorClassification));
+  compensationQueue =
+      xQueueCreate(DATA_QUEUE_LENGTH, sizeof(CompensatedFeatures));
+  monitorQueue = xQueueCreate(MONITOR_QUEUE_LENGTH, sizeof(MonitorBatch));
+  rawQueue = xQueueCreate(RAW_QUEUE_LENGTH, sizeof(RawSampleBlock));
+  // Apenas o comando mais recente importa (xQueueOverwrite)
+  commandQueue = xQueueCreate(1, sizeof(MonitorCommand));
 
-  if (dataQueue == NULL) {
-    Serial.println("Error creating the data queue");
+  if (dataQueue == NULL || classificationQueue == NULL ||
+      compensationQueue == NULL || monitorQueue == NULL || rawQueue == NULL ||
+      commandQueue == NULL) {
+    Serial.println("Error creating the data queues");
     while (1);
   }
 
+  bleManager.setCommandQueue(commandQueue);
+  bleManager.init();
+  serialLink.setCommandQueue(commandQueue);
+
   xTaskCreatePinnedToCore(
       sensorReaderTask,
       "SensorReaderTask",
@@ -181,7 +639,7 @@ void setup() {
   xTaskCreatePinnedToCore(
       dataTransferTask,
       "DataTransferTask",
-      4096,
+      8192,  // Lotes de pacotes e de monitoramento ficam na pilha
       NULL,
       1,
       &dataTransferTaskHandle,
@@ -0,0 +1,330 @@
+/**
+ * @file main.cpp
+ * @brief Converts CSV sessions written by e-nose_client.py into the columnar
+ * recording format (.enr) and optionally benchmarks both for bulk scans.
+ *
+ *   pio run -e csv2rec
+ *   .pio/build/csv2rec/program --out recordings data data_old
+ *   .pio/build/csv2rec/program --bench data data_old
+ *
+ * Each input may be a CSV file or a directory of CSVs. The scan plan is
+ * inferred from the header; files without a header are assumed to use the
+ * firmware's current plan. Missing values become NaN.
+ *
+ * Recordings go to --out DIR, never next to the inputs, and an existing
+ * recording is not overwritten. With --bench alone they are written to a
+ * temporary directory that is removed at the end.
+ */
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "RecordingReader.h"
+#include "RecordingWriter.h"
+#include "ScanPlan.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct CsvTable {
+  ScanPlan plan;
+  std::vector<int64_t> timestampsUs;
+  std::vector<float> values;  // Linha a linha, plan.columnNames().size() por linha
+  size_t bytes = 0;
+};
+
+// "2025-10-01 13:41:27.217330" -> microssegundos desde a época (hora local
+// do host na gravação, tratada como UTC para não depender do fuso atual)
+int64_t parseTimestampUs(const char* text) {
+  std::tm tm = {};
+  unsigned micros = 0;
+  int n = std::sscanf(
+      text,
+      "%d-%d-%d %d:%d:%d.%u",
+      &tm.tm_year,
+      &tm.tm_mon,
+      &tm.tm_mday,
+      &tm.tm_hour,
+      &tm.tm_min,
+      &tm.tm_sec,
+      &micros
+  );
+  if (n < 6) {
+    return 0;
+  }
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  return int64_t(timegm(&tm)) * 1000000 + micros;
+}
+
+std::vector<char*> splitFields(char* line) {
+  std::vector<char*> fields{line};
+  for (char* p = line; *p != '\0'; ++p) {
+    if (*p == ',') {
+      *p = '\0';
+      fields.push_back(p + 1);
+    } else if (*p == '\r') {
+      *p = '\0';
+      break;
+    }
+  }
+  return fields;
+}
+
+bool loadCsv(const fs::path& path, CsvTable& table) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::string content(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>()
+  );
+  table.bytes = content.size();
+  if (!content.empty() && content.back() != '\n') {
+    content.push_back('\n');
+  }
+
+  std::vector<int> sourceColumn;  // Coluna CSV de cada coluna do plano
+  size_t numColumns = 0;
+  bool firstLine = true;
+
+  size_t pos = 0;
+  while (pos < content.size()) {
+    size_t end = content.find('\n', pos);
+    content[end] = '\0';
+    std::vector<char*> fields = splitFields(&content[pos]);
+    pos = end + 1;
+    if (fields.size() == 1 && fields[0][0] == '\0') {
+      continue;
+    }
+
+    if (firstLine) {
+      firstLine = false;
+      bool hasHeader = std::string(fields[0]) == "Timestamp";
+      std::vector<std::string> header(fields.begin(), fields.end());
+      table.plan = hasHeader ? ScanPlan::fromColumnNames(header)
+                             : ScanPlan::firmwareDefault();
+      if (table.plan.frequenciesHz.empty()) {
+        return false;
+      }
+      std::vector<std::string> names = table.plan.columnNames();
+      numColumns = names.size();
+      // Sem cabeçalho os valores são as últimas colunas da linha: o prefixo
+      // é só o Timestamp nos arquivos antigos e Timestamp, Sequence e
+      // Device_ms nos atuais
+      if (!hasHeader && fields.size() <= numColumns) {
+        return false;
+      }
+      size_t firstValue = hasHeader ? 0 : fields.size() - numColumns;
+      for (size_t c = 0; c < numColumns; ++c) {
+        int source = hasHeader ? -1 : static_cast<int>(firstValue + c);
+        for (size_t h = 0; hasHeader && h < header.size(); ++h) {
+          if (header[h] == names[c]) {
+            source = static_cast<int>(h);
+            break;
+          }
+        }
+        sourceColumn.push_back(source);
+      }
+      if (hasHeader) {
+        continue;
+      }
+    }
+
+    table.timestampsUs.push_back(parseTimestampUs(fields[0]));
+    for (size_t c = 0; c < numColumns; ++c) {
+      int source = sourceColumn[c];
+      table.values.push_back(
+          source >= 0 && size_t(source) < fields.size()
+              ? std::strtof(fields[source], nullptr)
+              : NAN
+      );
+    }
+  }
+  return true;
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start
+  )
+      .count();
+}
+
+// Converte cada CSV para outDir e, com bench, compara as duas leituras
+int convertAndBench(
+    const std::vector<fs::path>& inputs, const std::string& outDir, bool bench
+) {
+  std::vector<fs::path> outputs;
+  size_t csvBytes = 0;
+  size_t totalRows = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const fs::path& input : inputs) {
+    CsvTable table;
+    if (!loadCsv(input, table)) {
+      std::fprintf(stderr, "WARN: skipping %s (no scan columns)\n", input.c_str());
+      continue;
+    }
+    fs::path output = fs::path(outDir) / input.filename();
+    output.replace_extension(".enr");
+    if (fs::exists(output)) {
+      std::fprintf(
+          stderr, "ERROR: %s already exists; not overwriting\n", output.c_str()
+      );
+      return 1;
+    }
+
+    RecordingWriter writer;
+    if (!writer.open(output.string(), table.plan)) {
+      std::fprintf(stderr, "ERROR: %s: %s\n", output.c_str(), writer.error().c_str());
+      return 1;
+    }
+    size_t numColumns = writer.columnCount();
+    for (size_t r = 0; r < table.timestampsUs.size(); ++r) {
+      writer.appendRow(table.timestampsUs[r], &table.values[r * numColumns]);
+    }
+    if (!writer.close()) {
+      std::fprintf(stderr, "ERROR: %s: %s\n", output.c_str(), writer.error().c_str());
+      return 1;
+    }
+    csvBytes += table.bytes;
+    totalRows += table.timestampsUs.size();
+    outputs.push_back(output);
+  }
+  double convertMs = msSince(start);
+  std::printf(
+      "Converted %zu files, %zu rows (%.1f MB of CSV) in %.1f ms\n",
+      outputs.size(),
+      totalRows,
+      csvBytes / 1e6,
+      convertMs
+  );
+
+  if (!bench) {
+    return 0;
+  }
+
+  // Mesma análise (média de cada coluna de todas as sessões) pelos dois
+  // caminhos: parse do CSV vs. leitura direta das colunas mapeadas
+  start = std::chrono::steady_clock::now();
+  double csvChecksum = 0.0;
+  for (const fs::path& input : inputs) {
+    CsvTable table;
+    if (loadCsv(input, table)) {
+      for (float v : table.values) {
+        csvChecksum += std::isnan(v) ? 0.0 : v;
+      }
+    }
+  }
+  double csvMs = msSince(start);
+
+  start = std::chrono::steady_clock::now();
+  double binChecksum = 0.0;
+  size_t binBytes = 0;
+  for (const fs::path& output : outputs) {
+    RecordingReader reader;
+    if (!reader.open(output.string())) {
+      std::fprintf(stderr, "ERROR: %s: %s\n", output.c_str(), reader.error().c_str());
+      return 1;
+    }
+    binBytes += fs::file_size(output);
+    for (size_t b = 0; b < reader.blockCount(); ++b) {
+      const RecordingBlock& block = reader.block(b);
+      for (const float* column : block.columns) {
+        for (uint32_t r = 0; r < block.rowCount; ++r) {
+          binChecksum += std::isnan(column[r]) ? 0.0 : column[r];
+        }
+      }
+    }
+  }
+  double binMs = msSince(start);
+
+  std::printf(
+      "CSV scan:    %8.2f ms (%.1f MB)   checksum %.6g\n"
+      "Binary scan: %8.2f ms (%.1f MB)   checksum %.6g\n"
+      "Speedup:     %.1fx\n",
+      csvMs,
+      csvBytes / 1e6,
+      csvChecksum,
+      binMs,
+      binBytes / 1e6,
+      binChecksum,
+      csvMs / binMs
+  );
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string outDir;
+  bool bench = false;
+  std::vector<fs::path> inputs;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--out" && i + 1 < argc) {
+      outDir = argv[++i];
+    } else if (arg == "--bench") {
+      bench = true;
+    } else if (fs::is_directory(arg)) {
+      for (const fs::directory_entry& e : fs::directory_iterator(arg)) {
+        if (e.path().extension() == ".csv") {
+          inputs.push_back(e.path());
+        }
+      }
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty() || (outDir.empty() && !bench)) {
+    std::fprintf(
+        stderr,
+        "Usage: %s --out DIR [--bench] CSV_OR_DIR...\n"
+        "       %s --bench CSV_OR_DIR...  (recordings are discarded)\n",
+        argv[0],
+        argv[0]
+    );
+    return 1;
+  }
+  std::sort(inputs.begin(), inputs.end());
+
+  // Só para o benchmark: as gravações ficam num diretório temporário
+  // removido no fim, nada é deixado junto dos CSVs
+  std::string tempDir;
+  if (outDir.empty()) {
+    std::string pattern =
+        (fs::temp_directory_path() / "csv2rec-XXXXXX").string();
+    if (mkdtemp(&pattern[0]) == nullptr) {
+      std::fprintf(stderr, "ERROR: cannot create a temporary directory\n");
+      return 1;
+    }
+    tempDir = outDir = pattern;
+  }
+  std::error_code ec;
+  fs::create_directories(outDir, ec);
+  if (ec) {
+    std::fprintf(
+        stderr, "ERROR: %s: %s\n", outDir.c_str(), ec.message().c_str()
+    );
+    return 1;
+  }
+  int status = convertAndBench(inputs, outDir, bench);
+  if (!tempDir.empty()) {
+    fs::remove_all(tempDir, ec);
+  }
+  return status;
+}
+
@@ -0,0 +1,239 @@
+/**
+ * @file main.cpp
+ * @brief Host replay of the drift compensator against synthetic baselines.
+ *
+ * Feeds DriftCompensator (lib/DriftCompensator, the same code as the
+ * firmware) with DataPackets whose lock-in means follow a known baseline:
+ * a slow aging ramp under steady and noisy temperature/humidity (steady
+ * readings excite only the offset term), a ramp under cycling conditions,
+ * a short odor exposure on top of the ramp, and SHT31 read failures while
+ * the BME680 reads offset conditions. It checks that the corrected
+ * residual stays within the noise plus the tracking lag of the forgetting
+ * factor, that it does not grow over the run and that only the exposure is
+ * gated. Exits with 1 if any check fails.
+ *
+ * Build and run from the repository root:
+ *   pio run -e drift_sim
+ *   .pio/build/drift_sim/program [--cycles N] [--seed N]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "DriftCompensator.h"
+
+namespace {
+
+// Ruído típico das médias do lock-in e dos sensores ambientais
+const double ADC_NOISE_V = 0.002;
+const double TEMPERATURE_NOISE_C = 0.02;
+const double HUMIDITY_NOISE_PCT = 0.1;
+
+struct Scenario {
+  const char* name;
+  double rampVPerCycle;       // Envelhecimento do sensor
+  bool environmentNoise;      // false: leituras de T/UR idênticas
+  double temperatureSwingC;   // Amplitude da oscilação de T (0 = constante)
+  double humiditySwingPct;    // Amplitude da oscilação de UR (0 = constante)
+  int swingPeriodCycles;
+  double exposureV;           // Degrau de odor (0 = sem exposição)
+  int exposureStart;
+  int exposureCycles;
+  int shtDropoutEvery;        // Falha de leitura do SHT31 (0 = nunca)
+};
+
+// Com T/UR exatamente constantes só b0 é excitado: é o caso que levava
+// o filtro ao windup
+const Scenario SCENARIOS[] = {
+    {"ramp, steady T/H", 0.0005, false, 0.0, 0.0, 1, 0.0, 0, 0, 0},
+    {"ramp, noisy T/H", 0.0005, true, 0.0, 0.0, 1, 0.0, 0, 0, 0},
+    {"ramp, cycling T/H", 0.0005, true, 3.0, 10.0, 150, 0.0, 0, 0, 0},
+    {"ramp, odor exposure", 0.0005, false, 0.0, 0.0, 1, 0.2, 500, 20, 0},
+    {"ramp, SHT31 dropouts", 0.0005, true, 3.0, 10.0, 150, 0.0, 0, 0, 7},
+};
+
+// O BME680 lê longe do SHT31 (nos dados, +0,8 °C e -6 %UR): misturar os
+// dois criaria degraus nos regressores
+const double BME_TEMPERATURE_OFFSET_C = 0.8;
+const double BME_HUMIDITY_OFFSET_PCT = -6.0;
+
+// Coeficientes de T e UR de cada ponto, em V/°C e V/%
+double temperatureCoefficient(int point) { return 0.004 + 0.0005 * point; }
+double humidityCoefficient(int point) { return -0.001 + 0.0001 * point; }
+
+struct Options {
+  int cycles = 1000;
+  unsigned seed = 1;
+};
+
+void printUsage(const char* argv0) {
+  std::fprintf(stderr, "Usage: %s [--cycles N] [--seed N]\n", argv0);
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--cycles" && hasValue) {
+      opts.cycles = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && hasValue) {
+      opts.seed = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else {
+      return false;
+    }
+  }
+  // O cenário de exposição precisa de ciclos depois do degrau
+  return opts.cycles >= 600;
+}
+
+// Executa um cenário; retorna false se alguma verificação falhar
+bool runScenario(const Scenario& sc, const Options& opts) {
+  std::mt19937 rng(opts.seed);
+  std::normal_distribution<double> adcNoise(0.0, ADC_NOISE_V);
+  std::normal_distribution<double> temperatureNoise(0.0, TEMPERATURE_NOISE_C);
+  std::normal_distribution<double> humidityNoise(0.0, HUMIDITY_NOISE_PCT);
+
+  DriftCompensator compensator;
+  DataPacket packet = {};
+  CompensatedFeatures features;
+
+  // Atraso de regime do RLS com esquecimento sobre uma rampa, mais o
+  // máximo do ruído em ~10^5 amostras (ampliado pelo ajuste a T/UR ruidosos)
+  const double lambda = DriftCompensator::FORGETTING_FACTOR;
+  const double lag = sc.rampVPerCycle * lambda / (1.0 - lambda);
+  const double bound = lag + 12.0 * ADC_NOISE_V;
+
+  // Estatísticas depois do transitório inicial, em duas metades
+  const int settle = 200;
+  const int half = settle + (opts.cycles - settle) / 2;
+  double maxResidual = 0.0;
+  double sumAbs[2] = {0.0, 0.0};
+  int count[2] = {0, 0};
+  int gatedOutside = 0;
+  int exposureGated = 0;
+
+  for (int cycle = 0; cycle < opts.cycles; ++cycle) {
+    double phase = 2.0 * M_PI * cycle / sc.swingPeriodCycles;
+    double dT = sc.temperatureSwingC * std::sin(phase);
+    double dH = sc.humiditySwingPct * std::cos(phase);
+    packet.sequence = cycle;
+    if (sc.environmentNoise) {
+      dT += temperatureNoise(rng);
+      dH += humidityNoise(rng);
+    }
+    packet.sht_temperature = 25.0 + dT;
+    packet.sht_humidity = 50.0 + dH;
+    packet.bme_temperature = packet.sht_temperature + BME_TEMPERATURE_OFFSET_C;
+    packet.bme_humidity = packet.sht_humidity + BME_HUMIDITY_OFFSET_PCT;
+    bool dropout = sc.shtDropoutEvery > 0 && cycle % sc.shtDropoutEvery == 3;
+    if (dropout) {
+      packet.sht_temperature = NAN;
+      packet.sht_humidity = NAN;
+    }
+
+    bool exposed = sc.exposureV != 0.0 && cycle >= sc.exposureStart &&
+                   cycle < sc.exposureStart + sc.exposureCycles;
+    for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+      double baseline = 1.0 + 0.05 * i + sc.rampVPerCycle * cycle +
+                        temperatureCoefficient(i) * dT +
+                        humidityCoefficient(i) * dH;
+      packet.adc_mean[i] =
+          baseline + (exposed ? sc.exposureV : 0.0) + adcNoise(rng);
+    }
+
+    // Uma falha de leitura deve ser sinalizada, e só ela
+    if (compensator.compensate(packet, features) == dropout) {
+      std::fprintf(
+          stderr, "FAIL: cycle %d %s\n", cycle, dropout ? "accepted" : "rejected"
+      );
+      return false;
+    }
+
+    if (exposed) {
+      for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+        exposureGated += (features.gated_mask >> i) & 1;
+      }
+      continue;
+    }
+    // Exposição recente: a linha de base ainda pode estar se readquirindo
+    bool recovering = sc.exposureV != 0.0 &&
+                      cycle >= sc.exposureStart + sc.exposureCycles &&
+                      cycle < sc.exposureStart + sc.exposureCycles + 20;
+    if (features.gated_mask != 0) {
+      gatedOutside++;
+    }
+    if (cycle < settle || recovering) {
+      continue;
+    }
+    int h = cycle < half ? 0 : 1;
+    for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+      double residual = std::fabs(features.adc_corrected[i]);
+      maxResidual = std::max(maxResidual, residual);
+      sumAbs[h] += residual;
+      count[h]++;
+    }
+  }
+
+  double meanAbs[2] = {sumAbs[0] / count[0], sumAbs[1] / count[1]};
+  std::printf(
+      "%-20s | max |residual| %.4f V (bound %.4f) | mean %.4f -> %.4f V | "
+      "%d gated cycles outside exposure",
+      sc.name,
+      maxResidual,
+      bound,
+      meanAbs[0],
+      meanAbs[1],
+      gatedOutside
+  );
+  if (sc.exposureV != 0.0) {
+    std::printf(
+        " | %d/%d exposure points gated",
+        exposureGated,
+        sc.exposureCycles * ADC_DATA_POINTS
+    );
+  }
+  std::printf("\n");
+
+  bool ok = true;
+  if (maxResidual > bound) {
+    std::fprintf(stderr, "FAIL: residual %.4f V above bound\n", maxResidual);
+    ok = false;
+  }
+  // Sem crescimento: a segunda metade não pode piorar além do ruído
+  if (meanAbs[1] > meanAbs[0] * 1.25 + 0.25 * ADC_NOISE_V) {
+    std::fprintf(stderr, "FAIL: residual grows over the run\n");
+    ok = false;
+  }
+  // Alarmes falsos raros (4 sigma em 24 pontos)
+  if (gatedOutside > opts.cycles / 50) {
+    std::fprintf(stderr, "FAIL: %d cycles gated in clean air\n", gatedOutside);
+    ok = false;
+  }
+  if (sc.exposureV != 0.0 &&
+      exposureGated < sc.exposureCycles * ADC_DATA_POINTS * 9 / 10) {
+    std::fprintf(stderr, "FAIL: odor exposure absorbed into the baseline\n");
+    ok = false;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  bool ok = true;
+  for (const Scenario& sc : SCENARIOS) {
+    ok = runScenario(sc, opts) && ok;
+  }
+  std::fprintf(stderr, ok ? "All checks passed\n" : "Some checks failed\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file main.cpp
+ * @brief Host simulation of the duty-cycled acquisition scheduler.
+ *
+ * Runs CycleScheduler (lib/CycleScheduler, the same code as the firmware)
+ * against a simulated clock with randomized sweep durations, wake-up latency
+ * and peripheral power-up time, for several (work, period) combinations. It
+ * checks that cycle deadlines are met without accumulated drift and that
+ * every microsecond is accounted for as work, low-power idle, awake idle or
+ * warm-up, then estimates the average current with a simple power model.
+ * Exits with 1 if any check fails.
+ *
+ * Build and run from the repository root:
+ *   pio run -e dutycycle_sim
+ *   .pio/build/dutycycle_sim/program [--cycles N] [--command-every-s S]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CycleScheduler.h"
+
+namespace {
+
+// Mesmos valores de src/main.cpp
+const uint32_t MIN_LOW_POWER_US = 20000;
+const uint32_t INITIAL_WARMUP_US = 5000;
+const uint32_t DEADLINE_TOLERANCE_US = 5000;
+const uint32_t WAVE_SETTLING_TIME_US = 1000;
+
+/**
+ * @brief Rough supply currents of the board, in mA.
+ */
+struct PowerModel {
+  double activeMa = 110.0;    // 240 MHz, BLE, AD9833 e sensor ligados
+  double idleMa = 55.0;       // 240 MHz ocioso, periféricos ligados
+  double lowPowerMa = 30.0;   // 80 MHz ocioso, AD9833 e mux desligados
+};
+
+struct Case {
+  double workMs;    // Duração média de uma varredura
+  double periodMs;  // CYCLE_DELAY_MS
+};
+
+// Varredura real (~22 s) com um período menor que ela (ciclos emendados),
+// o período do firmware (60 s) e outros períodos de campo, e ciclos curtos
+// para exercitar os intervalos sem baixo consumo
+const Case CASES[] = {
+    {22000.0, 1000.0},
+    {22000.0, 30000.0},
+    {22000.0, 60000.0},
+    {22000.0, 300000.0},
+    {400.0, 1000.0},
+    {400.0, 415.0},
+};
+
+/**
+ * @brief Simulated time base. Each call costs what it would on the device;
+ * the low-power wait wakes late by the CPU clock switch plus a random
+ * latency.
+ */
+class SimulatedPlatform : public SchedulerPlatform {
+ public:
+  SimulatedPlatform(unsigned seed, double commandEveryS)
+      : rng(seed), commandEveryUs(commandEveryS * 1e6) { }
+
+  uint64_t nowUs() override { return timeUs; }
+
+  bool idleUntilUs(uint64_t deadlineUs, bool lowPower) override {
+    if (commandEveryUs > 0.0) {
+      std::exponential_distribution<double> arrival(1.0 / commandEveryUs);
+      uint64_t commandAt = timeUs + static_cast<uint64_t>(arrival(rng));
+      if (commandAt < deadlineUs) {
+        timeUs = commandAt;
+        return false;
+      }
+    }
+    if (deadlineUs > timeUs) {
+      timeUs = deadlineUs;
+    }
+    if (lowPower) {
+      std::uniform_real_distribution<double> latency(0.0, 400.0);
+      timeUs += CPU_SWITCH_US + static_cast<uint64_t>(latency(rng));
+    }
+    return true;
+  }
+
+  void powerDownPeripherals() override { timeUs += 50; }
+
+  void powerUpPeripherals() override {
+    // ENoseController::powerUp(): modo SINE + assentamento
+    timeUs += 50 + WAVE_SETTLING_TIME_US;
+  }
+
+  void work(double meanMs) {
+    std::normal_distribution<double> duration(meanMs * 1000.0, meanMs * 20.0);
+    timeUs += static_cast<uint64_t>(std::max(duration(rng), 1.0));
+  }
+
+ private:
+  static const uint64_t CPU_SWITCH_US = 150;  // setCpuFrequencyMhz() x2
+
+  std::mt19937 rng;
+  double commandEveryUs;
+  uint64_t timeUs = 0;
+};
+
+struct Options {
+  int cycles = 200;
+  double commandEveryS = 0.0;
+  unsigned seed = 1;
+};
+
+void printUsage(const char* argv0) {
+  std::fprintf(
+      stderr,
+      "Usage: %s [--cycles N] [--command-every-s S] [--seed N]\n", argv0
+  );
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--cycles" && hasValue) {
+      opts.cycles = std::atoi(argv[++i]);
+    } else if (arg == "--command-every-s" && hasValue) {
+      opts.commandEveryS = std::atof(argv[++i]);
+    } else if (arg == "--seed" && hasValue) {
+      opts.seed = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else {
+      return false;
+    }
+  }
+  return opts.cycles > 1;
+}
+
+// Executa um caso como o laço de sensorReaderTask; retorna false se alguma
+// verificação falhar
+bool runCase(const Case& c, const Options& opts, const PowerModel& power) {
+  SimulatedPlatform platform(opts.seed, opts.commandEveryS);
+  SchedulerConfig config = {
+      static_cast<uint32_t>(c.periodMs * 1000.0),
+      MIN_LOW_POWER_US,
+      INITIAL_WARMUP_US,
+      DEADLINE_TOLERANCE_US,
+  };
+  CycleScheduler scheduler(platform, config);
+
+  uint64_t firstStart = 0;
+  uint64_t lastStart = 0;
+  for (int i = 0; i < opts.cycles; ++i) {
+    lastStart = scheduler.beginCycle();
+    if (i == 0) {
+      firstStart = lastStart;
+    }
+    platform.work(c.workMs);
+    scheduler.waitForNextCycle();
+  }
+  uint64_t elapsed = platform.nowUs() - firstStart;
+
+  const SchedulerStats& s = scheduler.stats();
+  uint64_t accounted = s.workUs + s.lowPowerUs + s.idleUs + s.warmUpUs;
+  double hours = elapsed / 3.6e9;
+  double mAh = (s.workUs + s.warmUpUs) / 3.6e9 * power.activeMa +
+               s.idleUs / 3.6e9 * power.idleMa +
+               s.lowPowerUs / 3.6e9 * power.lowPowerMa;
+  // Referência: o laço antigo com vTaskDelay, tudo ligado entre ciclos
+  double awakeMAh = s.workUs / 3.6e9 * power.activeMa +
+                    (elapsed - s.workUs) / 3.6e9 * power.idleMa;
+
+  std::printf(
+      "work %7.0f ms period %7.0f ms | %4u missed %4u overruns %3u interrupted"
+      " | max late %5u us warm-up %5u us | low power %5.1f%% | %5.1f mA "
+      "(always awake %5.1f mA)\n",
+      c.workMs,
+      c.periodMs,
+      s.missedDeadlines,
+      s.overruns,
+      s.interruptions,
+      s.maxLatenessUs,
+      scheduler.warmUpEstimateUs(),
+      100.0 * s.lowPowerUs / elapsed,
+      mAh / hours,
+      awakeMAh / hours
+  );
+
+  bool ok = true;
+  if (accounted != elapsed) {
+    std::fprintf(
+        stderr,
+        "FAIL: %llu us accounted for %llu us elapsed\n",
+        (unsigned long long) accounted,
+        (unsigned long long) elapsed
+    );
+    ok = false;
+  }
+  if (s.missedDeadlines > 0) {
+    std::fprintf(stderr, "FAIL: %u missed deadlines\n", s.missedDeadlines);
+    ok = false;
+  }
+  // Sem estouros nem interrupções, o plano não pode derivar
+  bool slack = c.workMs * 1.1 < c.periodMs;
+  if (slack && s.overruns > 0) {
+    std::fprintf(stderr, "FAIL: %u overruns with spare time\n", s.overruns);
+    ok = false;
+  }
+  // Com folga acima do mínimo a espera precisa entrar em baixo consumo
+  if (slack && c.periodMs - c.workMs > 2.0 * MIN_LOW_POWER_US / 1000.0 &&
+      s.lowPowerUs == 0) {
+    std::fprintf(stderr, "FAIL: no low-power time with spare time\n");
+    ok = false;
+  }
+  // Período menor que a varredura: todo ciclo estoura e começa em seguida,
+  // sem baixo consumo
+  bool noSlack = c.workMs > c.periodMs * 1.1;
+  if (noSlack && (s.overruns < (uint32_t) opts.cycles || s.lowPowerUs > 0)) {
+    std::fprintf(
+        stderr,
+        "FAIL: period shorter than the work, expected back-to-back cycles\n"
+    );
+    ok = false;
+  }
+  if (slack && s.interruptions == 0) {
+    double expected = (opts.cycles - 1) * c.periodMs * 1000.0;
+    double drift = std::fabs((double) (lastStart - firstStart) - expected);
+    if (drift > DEADLINE_TOLERANCE_US) {
+      std::fprintf(stderr, "FAIL: schedule drifted by %.0f us\n", drift);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  PowerModel power;
+  bool ok = true;
+  for (const Case& c : CASES) {
+    ok = runCase(c, opts, power) && ok;
+  }
+  std::fprintf(stderr, ok ? "All checks passed\n" : "Some checks failed\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file main.cpp
+ * @brief Gateway serving several E-Noses from one process.
+ *
+ *   pio run -e gateway
+ *   .pio/build/gateway/program \
+ *       --device nose1=unix-listen:/tmp/nose1.sock \
+ *       --device nose2=file:/dev/ttyUSB0 \
+ *       --out merged.csv --stats stats.jsonl
+ *
+ * All device streams are served by one poll() loop. Every packet is mapped
+ * from its device clock to the host clock, held for --window-ms to absorb
+ * jitter between devices, and written to a single time-ordered CSV with a
+ * Device column; an existing CSV with the same columns is appended to. Per-device throughput and loss counters are written as one
+ * JSON object per device every --stats-ms.
+ */
+
+#include <poll.h>
+#include <signal.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DeviceStream.h"
+#include "PacketSink.h"
+#include "StreamMerger.h"
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+struct RateSnapshot {
+  uint64_t packets = 0;
+  uint64_t bytes = 0;
+  uint64_t lost = 0;
+};
+
+void printUsage(const char* argv0) {
+  std::fprintf(
+      stderr,
+      "Usage: %s --device NAME=URI [--device NAME=URI]... [--out FILE]\n"
+      "          [--window-ms MS] [--stats FILE] [--stats-ms MS] [--once]\n",
+      argv0
+  );
+}
+
+void writeStats(
+    FILE* out,
+    const std::vector<std::unique_ptr<DeviceStream>>& devices,
+    std::vector<RateSnapshot>& previous,
+    double intervalS,
+    int64_t nowUs
+) {
+  for (size_t d = 0; d < devices.size(); ++d) {
+    const DeviceStats& s = devices[d]->stats();
+    RateSnapshot& prev = previous[d];
+    uint64_t expected = s.packets + s.lost;
+    std::fprintf(
+        out,
+        "{\"time_us\":%lld,\"device\":\"%s\",\"connected\":%s,"
+        "\"packets\":%llu,\"bytes\":%llu,\"lost\":%llu,\"duplicates\":%llu,"
+        "\"resets\":%llu,\"late\":%llu,\"connects\":%llu,"
+        "\"loss_ratio\":%.6f,\"packets_per_s\":%.3f,\"bytes_per_s\":%.1f,"
+        "\"lost_per_s\":%.3f,\"clock_offset_ms\":%.3f}\n",
+        static_cast<long long>(nowUs),
+        devices[d]->name().c_str(),
+        devices[d]->connected() ? "true" : "false",
+        (unsigned long long) s.packets,
+        (unsigned long long) s.bytes,
+        (unsigned long long) s.lost,
+        (unsigned long long) s.duplicates,
+        (unsigned long long) s.resets,
+        (unsigned long long) s.late,
+        (unsigned long long) s.connects,
+        expected > 0 ? double(s.lost) / expected : 0.0,
+        (s.packets - prev.packets) / intervalS,
+        (s.bytes - prev.bytes) / intervalS,
+        (s.lost - prev.lost) / intervalS,
+        devices[d]->clockOffsetMs()
+    );
+    prev = {s.packets, s.bytes, s.lost};
+  }
+  std::fflush(out);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::unique_ptr<DeviceStream>> devices;
+  std::string outPath;
+  std::string statsPath;
+  int windowMs = 500;
+  int statsMs = 5000;
+  bool once = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--device" && hasValue) {
+      std::string spec = argv[++i];
+      size_t eq = spec.find('=');
+      if (eq == std::string::npos || eq == 0) {
+        printUsage(argv[0]);
+        return 1;
+      }
+      devices.emplace_back(
+          new DeviceStream(spec.substr(0, eq), spec.substr(eq + 1))
+      );
+    } else if (arg == "--out" && hasValue) {
+      outPath = argv[++i];
+    } else if (arg == "--window-ms" && hasValue) {
+      windowMs = std::atoi(argv[++i]);
+    } else if (arg == "--stats" && hasValue) {
+      statsPath = argv[++i];
+    } else if (arg == "--stats-ms" && hasValue) {
+      statsMs = std::atoi(argv[++i]);
+    } else if (arg == "--once") {
+      once = true;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (devices.empty()) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  FILE* out = nullptr;
+  if (!outPath.empty()) {
+    // Como no receptor: reiniciar continua o mesmo arquivo em vez de
+    // truncá-lo
+    std::string error;
+    out = openCsvForAppend(outPath, csvHeader(",Device"), error);
+    if (out == nullptr) {
+      std::fprintf(stderr, "ERROR: %s: %s\n", outPath.c_str(), error.c_str());
+      return 1;
+    }
+  }
+  FILE* statsOut = stderr;
+  if (!statsPath.empty()) {
+    statsOut = std::fopen(statsPath.c_str(), "a");
+    if (statsOut == nullptr) {
+      std::fprintf(stderr, "ERROR: cannot open %s\n", statsPath.c_str());
+      return 1;
+    }
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  StreamMerger merger(int64_t(windowMs) * 1000);
+  std::string text;
+  uint64_t merged = 0;
+
+  auto emit = [&](const AlignedPacket& item, bool late) {
+    if (late) {
+      devices[item.device]->stats().late++;
+    }
+    merged++;
+    if (out == nullptr) {
+      return;
+    }
+    appendCsvTimestamp(text, item.alignedUs);
+    text += ',';
+    text += devices[item.device]->name();
+    appendCsvPacket(text, item.packet);
+    text += '\n';
+  };
+  auto flushText = [&]() {
+    if (out != nullptr && !text.empty()) {
+      std::fwrite(text.data(), 1, text.size(), out);
+      std::fflush(out);
+      text.clear();
+    }
+  };
+
+  std::vector<RateSnapshot> previous(devices.size());
+  auto lastStats = std::chrono::steady_clock::now();
+  std::vector<pollfd> pfds;
+  std::vector<size_t> pfdDevice;
+
+  while (!stopRequested) {
+    pfds.clear();
+    pfdDevice.clear();
+    bool allFinished = true;
+    for (size_t d = 0; d < devices.size(); ++d) {
+      devices[d]->maintainConnection(!once);
+      allFinished = allFinished && devices[d]->finished();
+      if (devices[d]->connected()) {
+        pfds.push_back({devices[d]->fd(), POLLIN, 0});
+        pfdDevice.push_back(d);
+      }
+    }
+    if (allFinished) {
+      break;
+    }
+
+    // Timeout curto: também governa a latência da janela de reordenação
+    ::poll(pfds.data(), pfds.size(), 20);
+    for (size_t p = 0; p < pfds.size(); ++p) {
+      if (pfds[p].revents != 0) {
+        size_t d = pfdDevice[p];
+        devices[d]->service(d, [&](const AlignedPacket& item) {
+          merger.push(item);
+        });
+      }
+    }
+
+    merger.drain(hostTimeUs(), emit);
+    if (text.size() > 64 * 1024) {
+      flushText();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsedS = std::chrono::duration<double>(now - lastStats).count();
+    if (elapsedS * 1000 >= statsMs) {
+      flushText();
+      writeStats(statsOut, devices, previous, elapsedS, hostTimeUs());
+      lastStats = now;
+    }
+  }
+
+  merger.drainAll(emit);
+  flushText();
+  double elapsedS = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - lastStats
+  )
+                        .count();
+  writeStats(statsOut, devices, previous, elapsedS, hostTimeUs());
+  std::fprintf(stderr, "Merged %llu packets\n", (unsigned long long) merged);
+
+  if (out != nullptr) {
+    std::fclose(out);
+  }
+  if (statsOut != stderr) {
+    std::fclose(statsOut);
+  }
+  return 0;
+}
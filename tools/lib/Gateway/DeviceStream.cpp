@@ -0,0 +1,111 @@
+#include "DeviceStream.h"
+
+#include <cstdio>
+#include <thread>
+
+#include "PacketSink.h"
+
+namespace {
+
+const std::chrono::seconds RECONNECT_DELAY(1);
+
+// Fração do excesso de atraso incorporada ao offset a cada pacote; segue a
+// deriva do relógio do dispositivo sem absorver picos de latência
+const double OFFSET_RISE_GAIN = 0.01;
+
+}  // namespace
+
+DeviceStream::DeviceStream(std::string name, std::string uri)
+    : deviceName(std::move(name)), sourceUri(std::move(uri)) { }
+
+void DeviceStream::maintainConnection(bool reconnect) {
+  if (transport || done) {
+    return;
+  }
+
+  if (pendingOpen.valid()) {
+    if (pendingOpen.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return;
+    }
+    transport = pendingOpen.get();
+    if (transport) {
+      everConnected = true;
+      counters.connects++;
+      std::fprintf(
+          stderr, "[%s] connected via %s\n", deviceName.c_str(), sourceUri.c_str()
+      );
+    } else {
+      retryAt = std::chrono::steady_clock::now() + RECONNECT_DELAY;
+    }
+    return;
+  }
+
+  if (everConnected && !reconnect) {
+    done = true;
+    return;
+  }
+  if (std::chrono::steady_clock::now() < retryAt) {
+    return;
+  }
+  // Sockets em modo listen bloqueiam em accept(); abrir em uma thread
+  // destacada mantém os demais dispositivos sendo atendidos e não impede o
+  // encerramento do processo enquanto um dispositivo nunca se conecta
+  std::string uri = sourceUri;
+  auto promise = std::make_shared<std::promise<std::unique_ptr<Transport>>>();
+  pendingOpen = promise->get_future();
+  std::thread([uri, promise]() {
+    std::string error;
+    std::unique_ptr<Transport> t = openTransport(uri, error);
+    if (!t) {
+      std::fprintf(stderr, "WARN: %s: %s\n", uri.c_str(), error.c_str());
+    }
+    promise->set_value(std::move(t));
+  }).detach();
+}
+
+void DeviceStream::disconnect() {
+  std::fprintf(stderr, "[%s] disconnected\n", deviceName.c_str());
+  transport.reset();
+  assembler = PacketAssembler();
+  retryAt = std::chrono::steady_clock::now() + RECONNECT_DELAY;
+}
+
+bool DeviceStream::accept(
+    const DataPacket& packet, int64_t arrivalUs, int64_t& alignedUs
+) {
+  // 1. Contabilidade da sequência
+  if (haveSequence) {
+    uint32_t expected = lastSequence + 1;
+    if (packet.sequence == expected) {
+      // Caso normal
+    } else if (packet.sequence > expected) {
+      counters.lost += packet.sequence - expected;
+    } else if (packet.timestamp_ms < lastDeviceMs) {
+      // Sequência e relógio voltaram juntos: o dispositivo reiniciou
+      counters.resets++;
+      haveOffset = false;
+    } else {
+      counters.duplicates++;
+      return false;
+    }
+  }
+  haveSequence = true;
+  lastSequence = packet.sequence;
+  lastDeviceMs = packet.timestamp_ms;
+  counters.packets++;
+
+  // 2. Mapeamento do relógio do dispositivo para o do host
+  int64_t deviceUs = int64_t(packet.timestamp_ms) * 1000;
+  int64_t candidate = arrivalUs - deviceUs;
+  if (!haveOffset || candidate < clockOffsetUs) {
+    clockOffsetUs = candidate;
+    haveOffset = true;
+  } else {
+    clockOffsetUs += static_cast<int64_t>(
+        (candidate - clockOffsetUs) * OFFSET_RISE_GAIN
+    );
+  }
+  alignedUs = deviceUs + clockOffsetUs;
+  return true;
+}
@@ -0,0 +1,130 @@
+#ifndef DEVICE_STREAM_H
+#define DEVICE_STREAM_H
+
+#include <stdint.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "PacketDecoder.h"
+#include "PacketSink.h"
+#include "Transport.h"
+
+/**
+ * @struct AlignedPacket
+ * @brief A packet placed on the gateway's common time axis.
+ */
+struct AlignedPacket {
+  int64_t alignedUs;  // Horário estimado do ciclo no relógio do host
+  int64_t arrivalUs;  // Horário de chegada no host
+  size_t device;      // Índice do dispositivo no gateway
+  uint64_t order;     // Ordem de entrada no StreamMerger (desempate)
+  DataPacket packet;
+};
+
+/**
+ * @struct DeviceStats
+ * @brief Cumulative counters of one device stream.
+ */
+struct DeviceStats {
+  uint64_t packets = 0;     // Pacotes aceitos
+  uint64_t bytes = 0;       // Bytes recebidos
+  uint64_t lost = 0;        // Lacunas na sequência
+  uint64_t duplicates = 0;  // Sequência repetida ou fora de ordem
+  uint64_t resets = 0;      // Reinícios do dispositivo (sequência voltou)
+  uint64_t late = 0;        // Chegaram depois da janela de reordenação
+  uint64_t connects = 0;
+};
+
+/**
+ * @class DeviceStream
+ * @brief One device feeding the gateway: transport, decoding, loss
+ * accounting and device-to-host clock mapping.
+ *
+ * The device clock (DataPacket::timestamp_ms) is mapped to host time with
+ * an offset that follows the smallest observed transport delay: it drops
+ * immediately to any faster arrival and rises slowly otherwise, so queueing
+ * jitter does not leak into the aligned timestamps while clock drift is
+ * still tracked.
+ */
+class DeviceStream {
+ public:
+  DeviceStream(std::string name, std::string uri);
+
+  const std::string& name() const { return deviceName; }
+  const std::string& uri() const { return sourceUri; }
+  const DeviceStats& stats() const { return counters; }
+  DeviceStats& stats() { return counters; }
+  bool connected() const { return transport != nullptr; }
+  int fd() const { return transport ? transport->fd() : -1; }
+  double clockOffsetMs() const { return clockOffsetUs / 1000.0; }
+
+  /**
+   * @brief Starts or completes a background (re)connection when needed.
+   * @param reconnect Whether to retry once a previous connection closed.
+   */
+  void maintainConnection(bool reconnect);
+
+  /**
+   * @brief Whether the stream closed and will not reconnect.
+   */
+  bool finished() const { return done; }
+
+  /**
+   * @brief Reads pending bytes and extracts every complete packet.
+   * @param onPacket Called with each accepted, aligned packet.
+   * @return false if the transport closed.
+   */
+  template <typename Fn>
+  bool service(size_t deviceIndex, Fn onPacket);
+
+ private:
+  std::string deviceName;
+  std::string sourceUri;
+  std::unique_ptr<Transport> transport;
+  std::future<std::unique_ptr<Transport>> pendingOpen;
+  std::chrono::steady_clock::time_point retryAt;
+  bool everConnected = false;
+  bool done = false;
+
+  PacketAssembler assembler;
+  DeviceStats counters;
+
+  bool haveSequence = false;
+  uint32_t lastSequence = 0;
+  uint32_t lastDeviceMs = 0;
+  bool haveOffset = false;
+  int64_t clockOffsetUs = 0;
+
+  bool accept(const DataPacket& packet, int64_t arrivalUs, int64_t& alignedUs);
+  void disconnect();
+};
+
+template <typename Fn>
+bool DeviceStream::service(size_t deviceIndex, Fn onPacket) {
+  if (!transport) {
+    return false;
+  }
+  uint8_t buffer[4096];
+  ssize_t n = transport->read(buffer, sizeof(buffer), 0);
+  if (n < 0) {
+    disconnect();
+    return false;
+  }
+  counters.bytes += static_cast<uint64_t>(n);
+  assembler.push(buffer, static_cast<size_t>(n));
+
+  AlignedPacket item;
+  item.device = deviceIndex;
+  while (assembler.next(item.packet)) {
+    item.arrivalUs = hostTimeUs();
+    if (accept(item.packet, item.arrivalUs, item.alignedUs)) {
+      onPacket(item);
+    }
+  }
+  return true;
+}
+
+#endif  // DEVICE_STREAM_H
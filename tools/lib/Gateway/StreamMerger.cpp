@@ -0,0 +1,7 @@
+#include "StreamMerger.h"
+
+void StreamMerger::push(const AlignedPacket& packet) {
+  AlignedPacket item = packet;
+  item.order = nextOrder++;
+  heap.push(item);
+}
@@ -0,0 +1,76 @@
+#ifndef STREAM_MERGER_H
+#define STREAM_MERGER_H
+
+#include <stdint.h>
+
+#include <queue>
+#include <vector>
+
+#include "DeviceStream.h"
+
+/**
+ * @class StreamMerger
+ * @brief Merges aligned packets from many devices into one time-ordered
+ * stream.
+ *
+ * Packets wait in a min-heap for `windowUs` after their aligned time, which
+ * absorbs the transport jitter between devices. A packet arriving after
+ * newer ones were already emitted is still emitted (and reported as late)
+ * rather than dropped.
+ */
+class StreamMerger {
+ public:
+  explicit StreamMerger(int64_t windowUs) : windowUs(windowUs) { }
+
+  void push(const AlignedPacket& packet);
+
+  /**
+   * @brief Emits every packet whose reordering window has elapsed.
+   * @param nowUs Current host time.
+   * @param emit Called as emit(packet, late).
+   */
+  template <typename Fn>
+  void drain(int64_t nowUs, Fn emit);
+
+  /**
+   * @brief Emits everything still buffered (shutdown).
+   */
+  template <typename Fn>
+  void drainAll(Fn emit) {
+    drain(INT64_MAX, emit);
+  }
+
+  size_t buffered() const { return heap.size(); }
+
+ private:
+  struct Later {
+    bool operator()(const AlignedPacket& a, const AlignedPacket& b) const {
+      // Empates (mesmo milissegundo do dispositivo) saem na ordem de chegada
+      if (a.alignedUs != b.alignedUs) {
+        return a.alignedUs > b.alignedUs;
+      }
+      return a.order > b.order;
+    }
+  };
+
+  std::priority_queue<AlignedPacket, std::vector<AlignedPacket>, Later> heap;
+  int64_t windowUs;
+  int64_t lastEmittedUs = INT64_MIN;
+  uint64_t nextOrder = 0;
+};
+
+template <typename Fn>
+void StreamMerger::drain(int64_t nowUs, Fn emit) {
+  int64_t limit = nowUs == INT64_MAX ? INT64_MAX : nowUs - windowUs;
+  while (!heap.empty() && heap.top().alignedUs <= limit) {
+    const AlignedPacket& top = heap.top();
+    bool late = top.alignedUs < lastEmittedUs;
+    if (!late) {
+      lastEmittedUs = top.alignedUs;
+    }
+    emit(top, late);
+    heap.pop();
+  }
+}
+
+#endif  // STREAM_MERGER_H
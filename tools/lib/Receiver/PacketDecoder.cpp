@@ -0,0 +1,28 @@
+#include "PacketDecoder.h"
+
+#include <cstring>
+
+void PacketAssembler::push(const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (decoder.push(data[i]) != DecodeResult::FRAME ||
+        decoder.type() != FRAME_DATA_PACKET) {
+      continue;
+    }
+    // CRC válido mas tamanho errado: outro layout de DataPacket
+    if (decoder.payloadSize() != sizeof(DataPacket)) {
+      badLength++;
+      continue;
+    }
+    ready.emplace_back();
+    std::memcpy(&ready.back(), decoder.payload(), sizeof(DataPacket));
+  }
+}
+
+bool PacketAssembler::next(DataPacket& packet) {
+  if (ready.empty()) {
+    return false;
+  }
+  packet = ready.front();
+  ready.pop_front();
+  return true;
+}
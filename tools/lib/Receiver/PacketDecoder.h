@@ -0,0 +1,62 @@
+#ifndef PACKET_DECODER_H
+#define PACKET_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+
+#include "ScanPlan.h"
+#include "SensorData.h"
+#include "SerialProtocol.h"
+
+// O pacote é copiado byte a byte do ESP32 (little-endian, sem padding):
+// 2 uint32 de cabeçalho seguidos apenas de floats
+static_assert(
+    offsetof(DataPacket, bme_temperature) == 2 * sizeof(uint32_t),
+    "DataPacket header changed"
+);
+static_assert(
+    sizeof(DataPacket) ==
+        2 * sizeof(uint32_t) + sizeof(float) * NUM_PACKET_VALUES,
+    "DataPacket must be a header followed by a packed array of floats"
+);
+static_assert(
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+    "Host must be little-endian to decode DataPacket in place"
+);
+
+/**
+ * @class PacketAssembler
+ * @brief Extracts DataPackets from a byte stream framed as on the serial
+ * link (lib/SerialProtocol).
+ *
+ * Stream transports (sockets, ptys, serial ports) may split, merge, drop or
+ * corrupt bytes. Each packet travels in its own COBS frame with a CRC, so a
+ * damaged frame is discarded and decoding resumes at the next delimiter
+ * instead of misaligning every packet that follows. Other frame types and
+ * the device logs are skipped.
+ */
+class PacketAssembler {
+ public:
+  /**
+   * @brief Decodes received bytes.
+   */
+  void push(const uint8_t* data, size_t size);
+
+  /**
+   * @brief Extracts the next complete packet, if any.
+   * @return true if `packet` was filled.
+   */
+  bool next(DataPacket& packet);
+
+  // Quadros descartados por CRC ou tamanho inválido
+  uint32_t decodeErrors() const { return decoder.decodeErrors() + badLength; }
+
+ private:
+  FrameDecoder<SERIAL_MAX_PAYLOAD> decoder;
+  std::deque<DataPacket> ready;
+  uint32_t badLength = 0;
+};
+
+#endif  // PACKET_DECODER_H
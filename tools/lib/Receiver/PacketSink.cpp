@@ -0,0 +1,183 @@
+#include "PacketSink.h"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include "ScanPlan.h"
+
+int64_t hostTimeUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch()
+  )
+      .count();
+}
+
+PacketSink::PacketSink(size_t batchSize, int flushIntervalMs)
+    : batchSize(batchSize > 0 ? batchSize : 1),
+      flushInterval(flushIntervalMs) {
+  pending.reserve(this->batchSize);
+}
+
+bool PacketSink::append(int64_t timestampUs, const DataPacket& packet) {
+  if (pending.empty()) {
+    firstPending = std::chrono::steady_clock::now();
+  }
+  pending.push_back({timestampUs, packet});
+  if (pending.size() >= batchSize) {
+    return flush();
+  }
+  return poll();
+}
+
+bool PacketSink::poll() {
+  if (!pending.empty() &&
+      std::chrono::steady_clock::now() - firstPending >= flushInterval) {
+    return flush();
+  }
+  return true;
+}
+
+bool PacketSink::flush() {
+  if (pending.empty()) {
+    return true;
+  }
+  bool ok = writeBatch(pending);
+  written += pending.size();
+  batches++;
+  pending.clear();
+  return ok;
+}
+
+// --- CSV ---
+
+std::string csvHeader(const std::string& extraColumns) {
+  std::string header = "Timestamp" + extraColumns + ",Sequence,Device_ms";
+  for (const std::string& name : ScanPlan::firmwareDefault().columnNames()) {
+    header += "," + name;
+  }
+  return header;
+}
+
+FILE* openCsvForAppend(
+    const std::string& path, const std::string& header, std::string& error
+) {
+  struct stat st;
+  bool isNew = ::stat(path.c_str(), &st) != 0 || st.st_size == 0;
+  FILE* file = std::fopen(path.c_str(), isNew ? "w" : "a+");
+  if (file == nullptr) {
+    error = std::strerror(errno);
+    return nullptr;
+  }
+  if (isNew) {
+    std::fprintf(file, "%s\n", header.c_str());
+    std::fflush(file);
+    return file;
+  }
+
+  // a+ lê do início e sempre escreve no fim
+  std::string existing;
+  int c;
+  while ((c = std::fgetc(file)) != EOF && c != '\n' && c != '\r') {
+    existing += static_cast<char>(c);
+  }
+  if (existing != header) {
+    std::fclose(file);
+    error = "existing file has a different column layout";
+    return nullptr;
+  }
+  // Leitura seguida de escrita exige reposicionar o fluxo
+  std::fseek(file, 0, SEEK_END);
+  return file;
+}
+
+void appendCsvTimestamp(std::string& text, int64_t timestampUs) {
+  char field[48];
+  time_t seconds = static_cast<time_t>(timestampUs / 1000000);
+  std::tm local;
+  localtime_r(&seconds, &local);
+  size_t len = std::strftime(field, sizeof(field), "%Y-%m-%d %H:%M:%S", &local);
+  std::snprintf(
+      field + len,
+      sizeof(field) - len,
+      ".%06lld",
+      static_cast<long long>(timestampUs % 1000000)
+  );
+  text += field;
+}
+
+void appendCsvPacket(std::string& text, const DataPacket& packet) {
+  char field[48];
+  std::snprintf(
+      field, sizeof(field), ",%u,%u", packet.sequence, packet.timestamp_ms
+  );
+  text += field;
+
+  const float* values = packetValues(packet);
+  for (size_t i = 0; i < NUM_PACKET_VALUES; ++i) {
+    // 9 dígitos significativos reproduzem exatamente o float32
+    std::snprintf(field, sizeof(field), ",%.9g", values[i]);
+    text += field;
+  }
+}
+
+CsvPacketSink::CsvPacketSink(size_t batchSize, int flushIntervalMs)
+    : PacketSink(batchSize, flushIntervalMs) { }
+
+CsvPacketSink::~CsvPacketSink() {
+  flush();
+  if (file != nullptr) {
+    std::fclose(file);
+  }
+}
+
+bool CsvPacketSink::open(const std::string& path) {
+  file = openCsvForAppend(path, csvHeader(), lastError);
+  return file != nullptr;
+}
+
+bool CsvPacketSink::writeBatch(const std::vector<TimestampedPacket>& batch) {
+  text.clear();
+  for (const TimestampedPacket& item : batch) {
+    appendCsvTimestamp(text, item.timestampUs);
+    appendCsvPacket(text, item.packet);
+    text += '\n';
+  }
+
+  if (file == nullptr ||
+      std::fwrite(text.data(), 1, text.size(), file) != text.size()) {
+    return false;
+  }
+  return std::fflush(file) == 0;
+}
+
+// --- Gravação colunar ---
+
+RecordingPacketSink::RecordingPacketSink(size_t batchSize, int flushIntervalMs)
+    : PacketSink(batchSize, flushIntervalMs) { }
+
+RecordingPacketSink::~RecordingPacketSink() {
+  flush();
+  writer.close();
+}
+
+bool RecordingPacketSink::open(const std::string& path) {
+  // Mesma regra do CSV: anexa a uma gravação existente de mesmo layout
+  struct stat st;
+  if (::stat(path.c_str(), &st) == 0 && st.st_size > 0) {
+    return writer.openForAppend(path, ScanPlan::firmwareDefault());
+  }
+  return writer.open(path, ScanPlan::firmwareDefault());
+}
+
+bool RecordingPacketSink::writeBatch(const std::vector<TimestampedPacket>& batch
+) {
+  for (const TimestampedPacket& item : batch) {
+    if (!writer.appendPacket(item.timestampUs, item.packet)) {
+      return false;
+    }
+  }
+  return writer.flush();
+}
@@ -0,0 +1,145 @@
+#ifndef PACKET_SINK_H
+#define PACKET_SINK_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "RecordingWriter.h"
+#include "SensorData.h"
+
+/**
+ * @struct TimestampedPacket
+ * @brief A DataPacket tagged with its host arrival time.
+ */
+struct TimestampedPacket {
+  int64_t timestampUs;  // Microssegundos desde a época (relógio do host)
+  DataPacket packet;
+};
+
+/**
+ * @brief Current host time in microseconds since the Unix epoch.
+ */
+int64_t hostTimeUs();
+
+/**
+ * @brief Header line of the CSV written by CsvPacketSink (no newline).
+ * @param extraColumns Columns inserted right after Timestamp, e.g. ",Device".
+ */
+std::string csvHeader(const std::string& extraColumns = "");
+
+/**
+ * @brief Opens a CSV for appending, writing `header` if the file is new.
+ *
+ * An existing file must start with exactly `header`: rows of another layout
+ * would otherwise be appended under shifted columns.
+ * @param error Filled with a message on failure.
+ * @return The open file, or nullptr on failure.
+ */
+FILE* openCsvForAppend(
+    const std::string& path, const std::string& header, std::string& error
+);
+
+/**
+ * @brief Appends "Timestamp" formatted like datetime.now() in the client.
+ */
+void appendCsvTimestamp(std::string& text, int64_t timestampUs);
+
+/**
+ * @brief Appends ",Sequence,Device_ms" and every packet value.
+ */
+void appendCsvPacket(std::string& text, const DataPacket& packet);
+
+/**
+ * @class PacketSink
+ * @brief Batched destination for received packets.
+ *
+ * append() only copies the packet into memory; the subclass writes the whole
+ * batch at once when it reaches batchSize packets or when flushIntervalMs
+ * has passed since the first buffered packet, whichever comes first.
+ */
+class PacketSink {
+ public:
+  PacketSink(size_t batchSize, int flushIntervalMs);
+  virtual ~PacketSink() = default;
+
+  bool append(int64_t timestampUs, const DataPacket& packet);
+
+  /**
+   * @brief Flushes the batch if its interval expired; call from idle loops.
+   */
+  bool poll();
+
+  bool flush();
+
+  size_t packetsWritten() const { return written; }
+  size_t batchesWritten() const { return batches; }
+
+ protected:
+  virtual bool writeBatch(const std::vector<TimestampedPacket>& batch) = 0;
+
+ private:
+  std::vector<TimestampedPacket> pending;
+  size_t batchSize;
+  std::chrono::milliseconds flushInterval;
+  std::chrono::steady_clock::time_point firstPending;
+  size_t written = 0;
+  size_t batches = 0;
+};
+
+/**
+ * @class CsvPacketSink
+ * @brief Writes packets with the same columns as e-nose_client.py
+ * (Timestamp, Sequence, Device_ms, then the packet values).
+ */
+class CsvPacketSink : public PacketSink {
+ public:
+  CsvPacketSink(size_t batchSize, int flushIntervalMs);
+  ~CsvPacketSink() override;
+
+  /**
+   * @brief Opens the CSV for appending, writing the header if it is new
+   * (see openCsvForAppend()).
+   */
+  bool open(const std::string& path);
+
+  const std::string& error() const { return lastError; }
+
+ protected:
+  bool writeBatch(const std::vector<TimestampedPacket>& batch) override;
+
+ private:
+  FILE* file = nullptr;
+  std::string text;
+  std::string lastError;
+};
+
+/**
+ * @class RecordingPacketSink
+ * @brief Writes packets to a columnar recording (.enr).
+ */
+class RecordingPacketSink : public PacketSink {
+ public:
+  RecordingPacketSink(size_t batchSize, int flushIntervalMs);
+  ~RecordingPacketSink() override;
+
+  /**
+   * @brief Opens the recording, appending if it already exists.
+   *
+   * As with CsvPacketSink, an existing file must have the current layout
+   * (see RecordingWriter::openForAppend()).
+   */
+  bool open(const std::string& path);
+  const std::string& error() const { return writer.error(); }
+
+ protected:
+  bool writeBatch(const std::vector<TimestampedPacket>& batch) override;
+
+ private:
+  RecordingWriter writer;
+};
+
+#endif  // PACKET_SINK_H
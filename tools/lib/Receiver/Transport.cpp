@@ -0,0 +1,292 @@
+#include "Transport.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/**
+ * Transport sobre um descritor POSIX qualquer (socket, pty, FIFO, stdin).
+ */
+class FdTransport : public Transport {
+ public:
+  FdTransport(int readFd, int writeFd, std::string name, bool ownsFd = true)
+      : readFd(readFd), writeFd(writeFd), label(std::move(name)), ownsFd(ownsFd) { }
+
+  ~FdTransport() override {
+    if (ownsFd) {
+      ::close(readFd);
+      if (writeFd != readFd) {
+        ::close(writeFd);
+      }
+    }
+  }
+
+  ssize_t read(uint8_t* data, size_t size, int timeoutMs) override {
+    pollfd pfd = {readFd, POLLIN, 0};
+    int ready = ::poll(&pfd, 1, timeoutMs);
+    if (ready < 0) {
+      return errno == EINTR ? 0 : -1;
+    }
+    if (ready == 0) {
+      return 0;
+    }
+    ssize_t n = ::read(readFd, data, size);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+      return 0;
+    }
+    // EOF (0) em um stream significa que o outro lado fechou
+    return n > 0 ? n : -1;
+  }
+
+  bool write(const uint8_t* data, size_t size) override {
+    while (size > 0) {
+      ssize_t n = ::write(writeFd, data, size);
+      if (n < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+          pollfd pfd = {writeFd, POLLOUT, 0};
+          ::poll(&pfd, 1, 100);
+          continue;
+        }
+        return false;
+      }
+      data += n;
+      size -= static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  int fd() const override { return readFd; }
+  const std::string& name() const override { return label; }
+
+ private:
+  int readFd;
+  int writeFd;
+  std::string label;
+  bool ownsFd;
+};
+
+void makeRaw(int fd) {
+  if (isatty(fd)) {
+    termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+      cfmakeraw(&tio);
+      tcsetattr(fd, TCSANOW, &tio);
+    }
+  }
+}
+
+speed_t baudConstant(long baud) {
+  switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    default: return B0;
+  }
+}
+
+int openSerial(const std::string& spec, std::string& error) {
+  std::string path = spec;
+  long baud = 921600;
+  size_t at = spec.rfind('@');
+  if (at != std::string::npos) {
+    path = spec.substr(0, at);
+    baud = std::atol(spec.c_str() + at + 1);
+  }
+  speed_t speed = baudConstant(baud);
+  if (speed == B0) {
+    error = "unsupported baud rate " + spec.substr(at + 1);
+    return -1;
+  }
+
+  int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    error = std::string("open: ") + std::strerror(errno);
+    return -1;
+  }
+  termios tio;
+  if (tcgetattr(fd, &tio) != 0) {
+    error = std::string("not a serial port: ") + std::strerror(errno);
+    ::close(fd);
+    return -1;
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+    error = std::string("tcsetattr: ") + std::strerror(errno);
+    ::close(fd);
+    return -1;
+  }
+  // Descarta o que a placa enviou antes da abertura (logs de boot)
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+int acceptOne(int listenFd, std::string& error) {
+  if (::listen(listenFd, 1) != 0) {
+    error = std::string("listen: ") + std::strerror(errno);
+    ::close(listenFd);
+    return -1;
+  }
+  int fd = ::accept(listenFd, nullptr, nullptr);
+  if (fd < 0) {
+    error = std::string("accept: ") + std::strerror(errno);
+  }
+  ::close(listenFd);
+  return fd;
+}
+
+int openUnix(const std::string& path, bool listen, std::string& error) {
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    error = "socket path too long";
+    return -1;
+  }
+  std::strcpy(addr.sun_path, path.c_str());
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    error = std::string("socket: ") + std::strerror(errno);
+    return -1;
+  }
+  if (listen) {
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+      error = std::string("bind: ") + std::strerror(errno);
+      ::close(fd);
+      return -1;
+    }
+    return acceptOne(fd, error);
+  }
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    error = std::string("connect: ") + std::strerror(errno);
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int openTcp(const std::string& host, const std::string& port, bool listen, std::string& error) {
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = listen ? AI_PASSIVE : 0;
+  addrinfo* res = nullptr;
+  int rc = ::getaddrinfo(
+      listen ? nullptr : host.c_str(), port.c_str(), &hints, &res
+  );
+  if (rc != 0) {
+    error = std::string("getaddrinfo: ") + gai_strerror(rc);
+    return -1;
+  }
+
+  int fd = -1;
+  for (addrinfo* ai = res; ai != nullptr && fd < 0; ai = ai->ai_next) {
+    fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    int one = 1;
+    if (listen) {
+      ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    int ok = listen ? ::bind(fd, ai->ai_addr, ai->ai_addrlen)
+                    : ::connect(fd, ai->ai_addr, ai->ai_addrlen);
+    if (ok != 0) {
+      error = std::strerror(errno);
+      ::close(fd);
+      fd = -1;
+    }
+  }
+  ::freeaddrinfo(res);
+  if (fd < 0) {
+    return -1;
+  }
+  return listen ? acceptOne(fd, error) : fd;
+}
+
+bool startsWith(const std::string& s, const char* prefix) {
+  return s.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+}  // namespace
+
+std::unique_ptr<Transport> openTransport(const std::string& uri, std::string& error) {
+  // Um par que fecha a conexão não deve derrubar o processo
+  ::signal(SIGPIPE, SIG_IGN);
+
+  int fd = -1;
+  if (uri == "-") {
+    return std::unique_ptr<Transport>(
+        new FdTransport(STDIN_FILENO, STDOUT_FILENO, "stdin", false)
+    );
+  } else if (startsWith(uri, "unix-listen:")) {
+    fd = openUnix(uri.substr(12), true, error);
+  } else if (startsWith(uri, "unix:")) {
+    fd = openUnix(uri.substr(5), false, error);
+  } else if (startsWith(uri, "tcp-listen:")) {
+    fd = openTcp("", uri.substr(11), true, error);
+  } else if (startsWith(uri, "tcp:")) {
+    std::string rest = uri.substr(4);
+    size_t colon = rest.rfind(':');
+    if (colon == std::string::npos) {
+      error = "expected tcp:HOST:PORT";
+      return nullptr;
+    }
+    fd = openTcp(rest.substr(0, colon), rest.substr(colon + 1), false, error);
+  } else if (startsWith(uri, "serial:")) {
+    fd = openSerial(uri.substr(7), error);
+  } else if (startsWith(uri, "file:")) {
+    fd = ::open(uri.substr(5).c_str(), O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+      error = std::string("open: ") + std::strerror(errno);
+    } else {
+      makeRaw(fd);
+    }
+  } else {
+    error = "unknown transport URI '" + uri + "'";
+    return nullptr;
+  }
+
+  if (fd < 0) {
+    return nullptr;
+  }
+  return std::unique_ptr<Transport>(new FdTransport(fd, fd, uri));
+}
+
+std::unique_ptr<Transport> openPtyMaster(std::string& slavePath, std::string& error) {
+  int fd = ::posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0 || ::grantpt(fd) != 0 || ::unlockpt(fd) != 0) {
+    error = std::string("pty: ") + std::strerror(errno);
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    return nullptr;
+  }
+  slavePath = ::ptsname(fd);
+  makeRaw(fd);
+  return std::unique_ptr<Transport>(new FdTransport(fd, fd, "pty:" + slavePath));
+}
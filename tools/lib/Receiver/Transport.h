@@ -0,0 +1,68 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+
+/**
+ * @class Transport
+ * @brief A bidirectional byte stream carrying packets from one device.
+ *
+ * The receiver only needs read(); write() lets the simulator and tests drive
+ * the other end through the same abstraction. Every implementation exposes
+ * a pollable file descriptor so several transports can share one event loop.
+ */
+class Transport {
+ public:
+  virtual ~Transport() = default;
+
+  /**
+   * @brief Reads available bytes, waiting at most timeoutMs.
+   * @return Bytes read, 0 on timeout, or -1 if the stream was closed.
+   */
+  virtual ssize_t read(uint8_t* data, size_t size, int timeoutMs) = 0;
+
+  /**
+   * @brief Writes all bytes, blocking until done.
+   */
+  virtual bool write(const uint8_t* data, size_t size) = 0;
+
+  virtual int fd() const = 0;
+  virtual const std::string& name() const = 0;
+};
+
+/**
+ * @brief Opens a transport from a URI.
+ *
+ * Supported forms:
+ *   unix:PATH          connect to a UNIX stream socket
+ *   unix-listen:PATH   listen on PATH and accept a single peer
+ *   tcp:HOST:PORT      connect over TCP
+ *   tcp-listen:PORT    listen on PORT and accept a single peer
+ *   file:PATH          open a pty, serial device or FIFO (raw mode if a tty)
+ *   serial:PATH[@BAUD] open a serial port in raw mode at BAUD (8N1, default
+ *                      921600, the firmware's SerialLink speed)
+ *   -                  standard input/output
+ *
+ * The BLE link is reached through e-nose_client.py --forward, which relays
+ * each packet to one of the socket forms above in a serial-link frame.
+ *
+ * @param uri The transport URI.
+ * @param error Filled with a message on failure.
+ * @return The open transport, or nullptr on failure.
+ */
+std::unique_ptr<Transport> openTransport(const std::string& uri, std::string& error);
+
+/**
+ * @brief Creates a pseudo-terminal pair for a simulated serial device.
+ * @param slavePath Filled with the path the receiver should open.
+ * @param error Filled with a message on failure.
+ * @return The master side, or nullptr on failure.
+ */
+std::unique_ptr<Transport> openPtyMaster(std::string& slavePath, std::string& error);
+
+#endif  // TRANSPORT_H
@@ -0,0 +1,87 @@
+#ifndef RECORDING_FORMAT_H
+#define RECORDING_FORMAT_H
+
+/**
+ * @file RecordingFormat.h
+ * @brief On-disk layout of the columnar recording format (.enr).
+ *
+ * A file is a header followed by fixed-size blocks:
+ *
+ *   FileHeader
+ *   uint32_t frequenciesHz[numFrequencies]
+ *   ColumnDescriptor columns[numColumns]
+ *   (zero padding up to headerSize, a multiple of BLOCK_ALIGNMENT)
+ *   Block 0, Block 1, ...
+ *
+ * Every block reserves room for rowsPerBlock rows, even the last one, so
+ * block i always starts at headerSize + i * blockSize and a partially filled
+ * block can be rewritten in place. Inside a block the data is column-major:
+ *
+ *   BlockHeader
+ *   int64_t timestampUs[rowsPerBlock]
+ *   float column0[rowsPerBlock], column1[rowsPerBlock], ...
+ *
+ * All integers and floats are little-endian, as on the ESP32 and x86 hosts.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace RecordingFormat {
+
+constexpr char MAGIC[8] = {'E', 'N', 'O', 'S', 'E', 'R', 'E', 'C'};
+constexpr uint16_t VERSION = 1;
+constexpr uint32_t BLOCK_MAGIC = 0x304B4C42;  // "BLK0"
+constexpr size_t BLOCK_ALIGNMENT = 64;
+constexpr size_t COLUMN_NAME_SIZE = 32;
+
+#pragma pack(push, 1)
+struct FileHeader {
+  char magic[8];
+  uint16_t version;
+  uint16_t numFrequencies;
+  uint16_t numChannels;
+  uint16_t numColumns;
+  uint32_t rowsPerBlock;
+  uint32_t headerSize;
+  uint64_t blockSize;
+};
+
+struct ColumnDescriptor {
+  char name[COLUMN_NAME_SIZE];  // Terminado em '\0', mesmo nome da coluna CSV
+};
+
+struct BlockHeader {
+  uint32_t magic;
+  uint32_t rowCount;  // Linhas válidas (<= rowsPerBlock)
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout changed");
+static_assert(sizeof(BlockHeader) == 8, "BlockHeader layout changed");
+
+inline size_t alignUp(size_t value) {
+  return (value + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+/**
+ * @brief Byte offset of the timestamp array inside a block.
+ * Kept 8-byte aligned so the mapped int64_t array can be read in place.
+ */
+inline size_t timestampOffset() { return sizeof(BlockHeader); }
+
+/**
+ * @brief Byte offset of column c inside a block.
+ */
+inline size_t columnOffset(uint32_t rowsPerBlock, size_t c) {
+  return timestampOffset() + sizeof(int64_t) * rowsPerBlock +
+         sizeof(float) * rowsPerBlock * c;
+}
+
+inline size_t blockSize(uint32_t rowsPerBlock, size_t numColumns) {
+  return alignUp(columnOffset(rowsPerBlock, numColumns));
+}
+
+}  // namespace RecordingFormat
+
+#endif  // RECORDING_FORMAT_H
@@ -0,0 +1,120 @@
+#include "RecordingReader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+using namespace RecordingFormat;
+
+RecordingReader::~RecordingReader() { close(); }
+
+bool RecordingReader::open(const std::string& path) {
+  close();
+  lastError.clear();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return fail("cannot open " + path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(FileHeader)) {
+    ::close(fd);
+    return fail("file too small to be a recording");
+  }
+  mappingSize = static_cast<size_t>(st.st_size);
+  mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    mapping = nullptr;
+    return fail("mmap failed");
+  }
+  // Leituras são majoritariamente sequenciais por coluna
+  madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+
+  const uint8_t* base = static_cast<const uint8_t*>(mapping);
+  FileHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    return fail("bad magic");
+  }
+  if (header.version != VERSION) {
+    return fail("unsupported version " + std::to_string(header.version));
+  }
+  size_t tableSize = sizeof(FileHeader) +
+                     sizeof(uint32_t) * header.numFrequencies +
+                     sizeof(ColumnDescriptor) * header.numColumns;
+  if (header.headerSize < tableSize || header.headerSize > mappingSize ||
+      header.blockSize != blockSize(header.rowsPerBlock, header.numColumns)) {
+    return fail("corrupt header");
+  }
+
+  const uint8_t* p = base + sizeof(FileHeader);
+  scanPlan.frequenciesHz.resize(header.numFrequencies);
+  std::memcpy(
+      scanPlan.frequenciesHz.data(), p, sizeof(uint32_t) * header.numFrequencies
+  );
+  scanPlan.numChannels = header.numChannels;
+  p += sizeof(uint32_t) * header.numFrequencies;
+  for (uint16_t c = 0; c < header.numColumns; ++c) {
+    ColumnDescriptor column;
+    std::memcpy(&column, p, sizeof(column));
+    column.name[COLUMN_NAME_SIZE - 1] = '\0';
+    names.push_back(column.name);
+    p += sizeof(column);
+  }
+
+  // Blocos têm tamanho fixo: o bloco i está em headerSize + i * blockSize
+  size_t available = (mappingSize - header.headerSize) / header.blockSize;
+  for (size_t i = 0; i < available; ++i) {
+    const uint8_t* blockBase = base + header.headerSize + i * header.blockSize;
+    BlockHeader blockHeader;
+    std::memcpy(&blockHeader, blockBase, sizeof(blockHeader));
+    if (blockHeader.magic != BLOCK_MAGIC ||
+        blockHeader.rowCount > header.rowsPerBlock) {
+      break;  // Bloco ainda não escrito (gravação interrompida)
+    }
+
+    RecordingBlock block;
+    block.rowCount = blockHeader.rowCount;
+    block.timestampsUs =
+        reinterpret_cast<const int64_t*>(blockBase + timestampOffset());
+    for (uint16_t c = 0; c < header.numColumns; ++c) {
+      block.columns.push_back(reinterpret_cast<const float*>(
+          blockBase + columnOffset(header.rowsPerBlock, c)
+      ));
+    }
+    totalRows += block.rowCount;
+    blocks.push_back(std::move(block));
+  }
+  return true;
+}
+
+void RecordingReader::close() {
+  if (mapping != nullptr) {
+    munmap(mapping, mappingSize);
+  }
+  mapping = nullptr;
+  mappingSize = 0;
+  scanPlan = ScanPlan();
+  names.clear();
+  blocks.clear();
+  totalRows = 0;
+}
+
+int RecordingReader::columnIndex(const std::string& name) const {
+  for (size_t c = 0; c < names.size(); ++c) {
+    if (names[c] == name) {
+      return static_cast<int>(c);
+    }
+  }
+  return -1;
+}
+
+bool RecordingReader::fail(const std::string& message) {
+  lastError = message;
+  close();
+  return false;
+}
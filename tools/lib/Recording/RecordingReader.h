@@ -0,0 +1,71 @@
+#ifndef RECORDING_READER_H
+#define RECORDING_READER_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "RecordingFormat.h"
+#include "ScanPlan.h"
+
+/**
+ * @struct RecordingBlock
+ * @brief Zero-copy view of one block of a mapped recording.
+ * The pointers stay valid while the RecordingReader is open.
+ */
+struct RecordingBlock {
+  uint32_t rowCount = 0;
+  const int64_t* timestampsUs = nullptr;
+  std::vector<const float*> columns;  // columns[c][row]
+};
+
+/**
+ * @class RecordingReader
+ * @brief Read-only, memory-mapped access to a columnar recording file.
+ *
+ * Nothing is parsed or copied: column arrays are returned as pointers into
+ * the mapping, so a scan over one column only touches the pages holding it.
+ */
+class RecordingReader {
+ public:
+  RecordingReader() = default;
+  ~RecordingReader();
+
+  RecordingReader(const RecordingReader&) = delete;
+  RecordingReader& operator=(const RecordingReader&) = delete;
+
+  /**
+   * @brief Maps and validates a recording file.
+   * @return true on success, otherwise see error().
+   */
+  bool open(const std::string& path);
+
+  void close();
+
+  const ScanPlan& plan() const { return scanPlan; }
+  const std::vector<std::string>& columnNames() const { return names; }
+  size_t blockCount() const { return blocks.size(); }
+  size_t rowCount() const { return totalRows; }
+  const RecordingBlock& block(size_t i) const { return blocks[i]; }
+  const std::string& error() const { return lastError; }
+
+  /**
+   * @brief Finds a column by its CSV name.
+   * @return The column index, or -1 if it does not exist.
+   */
+  int columnIndex(const std::string& name) const;
+
+ private:
+  void* mapping = nullptr;
+  size_t mappingSize = 0;
+  ScanPlan scanPlan;
+  std::vector<std::string> names;
+  std::vector<RecordingBlock> blocks;
+  size_t totalRows = 0;
+  std::string lastError;
+
+  bool fail(const std::string& message);
+};
+
+#endif  // RECORDING_READER_H
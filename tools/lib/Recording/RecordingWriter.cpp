@@ -0,0 +1,210 @@
+#include "RecordingWriter.h"
+
+#include <unistd.h>
+
+#include <cstring>
+
+using namespace RecordingFormat;
+
+RecordingWriter::~RecordingWriter() { close(); }
+
+bool RecordingWriter::buildHeader(
+    const ScanPlan& plan, uint32_t rowsPerBlock, std::vector<uint8_t>& bytes
+) {
+  std::vector<std::string> names = plan.columnNames();
+  if (rowsPerBlock == 0 || plan.frequenciesHz.empty() || plan.numChannels == 0) {
+    return fail("invalid scan plan or block size");
+  }
+
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.numFrequencies = static_cast<uint16_t>(plan.frequenciesHz.size());
+  header.numChannels = plan.numChannels;
+  header.numColumns = static_cast<uint16_t>(names.size());
+  header.rowsPerBlock = rowsPerBlock;
+  header.headerSize = static_cast<uint32_t>(alignUp(
+      sizeof(FileHeader) + sizeof(uint32_t) * plan.frequenciesHz.size() +
+      sizeof(ColumnDescriptor) * names.size()
+  ));
+  header.blockSize = RecordingFormat::blockSize(rowsPerBlock, names.size());
+
+  bytes.assign(header.headerSize, 0);
+  uint8_t* p = bytes.data();
+  std::memcpy(p, &header, sizeof(header));
+  p += sizeof(header);
+  std::memcpy(
+      p, plan.frequenciesHz.data(), sizeof(uint32_t) * plan.frequenciesHz.size()
+  );
+  p += sizeof(uint32_t) * plan.frequenciesHz.size();
+  for (const std::string& name : names) {
+    ColumnDescriptor column = {};
+    std::strncpy(column.name, name.c_str(), COLUMN_NAME_SIZE - 1);
+    std::memcpy(p, &column, sizeof(column));
+    p += sizeof(column);
+  }
+
+  this->numColumns = names.size();
+  this->rowsPerBlock = rowsPerBlock;
+  this->headerSize = header.headerSize;
+  this->blockSize = header.blockSize;
+  blockIndex = 0;
+  rowsInBlock = 0;
+  totalRows = 0;
+  block.assign(blockSize, 0);
+  return true;
+}
+
+bool RecordingWriter::open(
+    const std::string& path, const ScanPlan& plan, uint32_t rowsPerBlock
+) {
+  close();
+  lastError.clear();
+
+  std::vector<uint8_t> headerBytes;
+  if (!buildHeader(plan, rowsPerBlock, headerBytes)) {
+    return false;
+  }
+  file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return fail("cannot create " + path);
+  }
+  if (std::fwrite(headerBytes.data(), 1, headerBytes.size(), file) !=
+      headerBytes.size()) {
+    return fail("cannot write header");
+  }
+  return true;
+}
+
+bool RecordingWriter::openForAppend(
+    const std::string& path, const ScanPlan& plan, uint32_t rowsPerBlock
+) {
+  close();
+  lastError.clear();
+
+  std::vector<uint8_t> expected;
+  if (!buildHeader(plan, rowsPerBlock, expected)) {
+    return false;
+  }
+  FILE* existing = std::fopen(path.c_str(), "r+b");
+  if (existing == nullptr) {
+    return fail("cannot open " + path);
+  }
+  // Só anexa sobre um cabeçalho idêntico: outro plano ou tamanho de bloco
+  // deslocaria todas as colunas
+  std::vector<uint8_t> found(expected.size());
+  if (std::fread(found.data(), 1, found.size(), existing) != found.size() ||
+      found != expected) {
+    std::fclose(existing);
+    return fail("existing file has a different scan plan or block size");
+  }
+  file = existing;
+
+  // Continua depois do último bloco válido, completando-o se estiver
+  // parcial; o que vier depois é resto de uma escrita interrompida
+  BlockHeader header;
+  while (std::fread(&header, sizeof(header), 1, file) == 1 &&
+         header.magic == BLOCK_MAGIC && header.rowCount <= rowsPerBlock) {
+    totalRows += header.rowCount;
+    if (header.rowCount < rowsPerBlock) {
+      long offset = static_cast<long>(headerSize + blockIndex * blockSize);
+      if (std::fseek(file, offset, SEEK_SET) != 0 ||
+          std::fread(block.data(), 1, blockSize, file) != blockSize) {
+        std::fclose(file);
+        file = nullptr;
+        return fail("cannot read the last block");
+      }
+      rowsInBlock = header.rowCount;
+      break;
+    }
+    blockIndex++;
+    long next = static_cast<long>(headerSize + blockIndex * blockSize);
+    if (std::fseek(file, next, SEEK_SET) != 0) {
+      break;
+    }
+  }
+  size_t usedBlocks = blockIndex + (rowsInBlock > 0 ? 1 : 0);
+  if (std::fflush(file) != 0 ||
+      ftruncate(fileno(file), headerSize + usedBlocks * blockSize) != 0) {
+    std::fclose(file);
+    file = nullptr;
+    return fail("cannot discard the interrupted block");
+  }
+  return true;
+}
+
+bool RecordingWriter::appendRow(int64_t timestampUs, const float* values) {
+  if (file == nullptr) {
+    return fail("recording is not open");
+  }
+
+  uint8_t* base = block.data();
+  std::memcpy(
+      base + timestampOffset() + sizeof(int64_t) * rowsInBlock,
+      &timestampUs,
+      sizeof(int64_t)
+  );
+  for (size_t c = 0; c < numColumns; ++c) {
+    std::memcpy(
+        base + columnOffset(rowsPerBlock, c) + sizeof(float) * rowsInBlock,
+        &values[c],
+        sizeof(float)
+    );
+  }
+  rowsInBlock++;
+  totalRows++;
+
+  if (rowsInBlock == rowsPerBlock) {
+    if (!writeBlock()) {
+      return false;
+    }
+    blockIndex++;
+    rowsInBlock = 0;
+    std::memset(block.data(), 0, block.size());
+  }
+  return true;
+}
+
+bool RecordingWriter::appendPacket(int64_t timestampUs, const DataPacket& packet) {
+  if (numColumns != NUM_PACKET_VALUES) {
+    return fail("scan plan does not match the firmware DataPacket");
+  }
+  return appendRow(timestampUs, packetValues(packet));
+}
+
+bool RecordingWriter::flush() {
+  if (file == nullptr) {
+    return fail("recording is not open");
+  }
+  if (rowsInBlock > 0 && !writeBlock()) {
+    return false;
+  }
+  return std::fflush(file) == 0 || fail("fflush failed");
+}
+
+bool RecordingWriter::close() {
+  if (file == nullptr) {
+    return true;
+  }
+  bool ok = flush();
+  ok = (std::fclose(file) == 0) && ok;
+  file = nullptr;
+  return ok;
+}
+
+bool RecordingWriter::writeBlock() {
+  BlockHeader header = {BLOCK_MAGIC, rowsInBlock};
+  std::memcpy(block.data(), &header, sizeof(header));
+
+  long offset = static_cast<long>(headerSize + blockIndex * blockSize);
+  if (std::fseek(file, offset, SEEK_SET) != 0 ||
+      std::fwrite(block.data(), 1, block.size(), file) != block.size()) {
+    return fail("cannot write block");
+  }
+  return true;
+}
+
+bool RecordingWriter::fail(const std::string& message) {
+  lastError = message;
+  return false;
+}
@@ -0,0 +1,102 @@
+#ifndef RECORDING_WRITER_H
+#define RECORDING_WRITER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "RecordingFormat.h"
+#include "ScanPlan.h"
+#include "SensorData.h"
+
+/**
+ * @class RecordingWriter
+ * @brief Streams rows into a columnar recording file.
+ *
+ * Rows are accumulated in an in-memory block and written once per block.
+ * flush() writes the partially filled block at its final offset, so a
+ * reader (or a crash) always sees every row appended before the last flush;
+ * the next flush or close() simply overwrites it.
+ */
+class RecordingWriter {
+ public:
+  RecordingWriter() = default;
+  ~RecordingWriter();
+
+  RecordingWriter(const RecordingWriter&) = delete;
+  RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+  /**
+   * @brief Creates (truncates) a recording file.
+   * @param path Destination file.
+   * @param plan Scan shape; defines the value columns.
+   * @param rowsPerBlock Rows per block; 256 keeps blocks around 60 KB.
+   * @return true on success, otherwise see error().
+   */
+  bool open(
+      const std::string& path, const ScanPlan& plan, uint32_t rowsPerBlock = 256
+  );
+
+  /**
+   * @brief Reopens an existing recording to add rows after its last one.
+   *
+   * The file header must be exactly the one open() would write for the same
+   * plan and block size; otherwise the file is left untouched. A partially
+   * filled last block is completed in place, and blocks after the last
+   * valid one (an interrupted write) are discarded.
+   * @return true on success, otherwise see error().
+   */
+  bool openForAppend(
+      const std::string& path, const ScanPlan& plan, uint32_t rowsPerBlock = 256
+  );
+
+  /**
+   * @brief Appends one row of plan.columnNames().size() values.
+   * @param timestampUs Arrival time, microseconds since the Unix epoch.
+   * @param values The row values, in column order.
+   */
+  bool appendRow(int64_t timestampUs, const float* values);
+
+  /**
+   * @brief Appends the values of a DataPacket (its sequence/timestamp header
+   * is not stored); the plan must match the firmware layout.
+   */
+  bool appendPacket(int64_t timestampUs, const DataPacket& packet);
+
+  /**
+   * @brief Makes every appended row visible on disk.
+   */
+  bool flush();
+
+  /**
+   * @brief Flushes and closes the file.
+   */
+  bool close();
+
+  bool isOpen() const { return file != nullptr; }
+  size_t rowCount() const { return totalRows; }
+  size_t columnCount() const { return numColumns; }
+  const std::string& error() const { return lastError; }
+
+ private:
+  FILE* file = nullptr;
+  size_t numColumns = 0;
+  uint32_t rowsPerBlock = 0;
+  uint32_t headerSize = 0;
+  size_t blockSize = 0;
+  size_t blockIndex = 0;
+  uint32_t rowsInBlock = 0;
+  size_t totalRows = 0;
+  std::vector<uint8_t> block;
+  std::string lastError;
+
+  bool buildHeader(
+      const ScanPlan& plan, uint32_t rowsPerBlock, std::vector<uint8_t>& bytes
+  );
+  bool writeBlock();
+  bool fail(const std::string& message);
+};
+
+#endif  // RECORDING_WRITER_H
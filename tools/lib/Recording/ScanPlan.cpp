@@ -0,0 +1,61 @@
+#include "ScanPlan.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "SensorData.h"
+
+namespace {
+
+const char* const ENVIRONMENT_COLUMNS[NUM_ENVIRONMENT_COLUMNS] = {
+    "BME_Temp", "BME_Hum", "BME_Pres", "BME_Gas", "SHT_Temp",
+    "SHT_Hum",  "MQ3",     "MQ135",    "MQ136",   "MQ137"
+};
+
+}  // namespace
+
+ScanPlan ScanPlan::firmwareDefault() {
+  ScanPlan plan;
+  plan.frequenciesHz.assign(
+      ActiveScan::FREQUENCIES_HZ,
+      ActiveScan::FREQUENCIES_HZ + ActiveScan::NUM_FREQUENCIES
+  );
+  plan.numChannels = NUM_CANAIS;
+  return plan;
+}
+
+ScanPlan ScanPlan::fromColumnNames(const std::vector<std::string>& names) {
+  ScanPlan plan;
+  for (const std::string& name : names) {
+    unsigned ch = 0;
+    unsigned freq = 0;
+    char suffix[16] = {0};
+    if (std::sscanf(name.c_str(), "Ch%u_F%uHz_%15s", &ch, &freq, suffix) != 3 ||
+        std::string(suffix) != "Mean") {
+      continue;
+    }
+    if (std::find(plan.frequenciesHz.begin(), plan.frequenciesHz.end(), freq) ==
+        plan.frequenciesHz.end()) {
+      plan.frequenciesHz.push_back(freq);
+    }
+    plan.numChannels = std::max<uint16_t>(plan.numChannels, ch);
+  }
+  return plan;
+}
+
+std::vector<std::string> ScanPlan::columnNames() const {
+  std::vector<std::string> names(
+      ENVIRONMENT_COLUMNS, ENVIRONMENT_COLUMNS + NUM_ENVIRONMENT_COLUMNS
+  );
+  for (const char* stat : {"Mean", "StdDev"}) {
+    for (uint32_t freq : frequenciesHz) {
+      for (unsigned ch = 1; ch <= numChannels; ++ch) {
+        names.push_back(
+            "Ch" + std::to_string(ch) + "_F" + std::to_string(freq) + "Hz_" +
+            stat
+        );
+      }
+    }
+  }
+  return names;
+}
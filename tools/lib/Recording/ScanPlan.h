@@ -0,0 +1,67 @@
+#ifndef SCAN_PLAN_H
+#define SCAN_PLAN_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "SensorData.h"
+
+/**
+ * @struct ScanPlan
+ * @brief Frequency/channel shape of a sweep, i.e. the layout of adc_mean and
+ * adc_std_dev in a DataPacket.
+ */
+struct ScanPlan {
+  std::vector<uint32_t> frequenciesHz;
+  uint16_t numChannels = 0;
+
+  size_t dataPoints() const { return frequenciesHz.size() * numChannels; }
+
+  /**
+   * @brief The plan currently compiled into the firmware (ActiveScan).
+   */
+  static ScanPlan firmwareDefault();
+
+  /**
+   * @brief Infers the plan from the `Ch{n}_F{f}Hz_Mean` columns of a CSV
+   * header, keeping the frequencies in the order they first appear.
+   * @return An empty plan (no frequencies) if no such column is found.
+   */
+  static ScanPlan fromColumnNames(const std::vector<std::string>& names);
+
+  /**
+   * @brief Names of every value column, in DataPacket order.
+   *
+   * Matches COLUMN_NAMES in e-nose_client.py without the leading Timestamp:
+   * the 10 commercial sensors, then every mean, then every standard
+   * deviation, each frequency-major.
+   */
+  std::vector<std::string> columnNames() const;
+};
+
+/**
+ * @brief Number of commercial-sensor floats at the start of a DataPacket.
+ */
+constexpr size_t NUM_ENVIRONMENT_COLUMNS = 10;
+
+/**
+ * @brief Number of floats in a DataPacket after its sequence/timestamp
+ * header; these are the value columns of the firmware's scan plan.
+ */
+constexpr size_t NUM_PACKET_VALUES =
+    NUM_ENVIRONMENT_COLUMNS + 2 * ADC_DATA_POINTS;
+
+/**
+ * @brief The float values of a packet, in column order.
+ */
+inline const float* packetValues(const DataPacket& packet) {
+  return &packet.bme_temperature;
+}
+
+inline float* packetValues(DataPacket& packet) {
+  return &packet.bme_temperature;
+}
+
+#endif  // SCAN_PLAN_H
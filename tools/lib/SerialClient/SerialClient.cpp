@@ -0,0 +1,171 @@
+#include "SerialClient.h"
+
+#include <chrono>
+
+namespace {
+
+int64_t epochUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch()
+  )
+      .count();
+}
+
+int64_t steadyMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()
+  )
+      .count();
+}
+
+}  // namespace
+
+SerialClient::SerialClient(std::unique_ptr<Transport> transport)
+    : link(std::move(transport)),
+      decoder(new FrameDecoder<SERIAL_MAX_PAYLOAD>()) { }
+
+void SerialClient::setLogHandler(
+    std::function<void(const std::string&)> handler
+) {
+  logHandler = std::move(handler);
+}
+
+bool SerialClient::ping(int timeoutMs) {
+  uint8_t status = 0;
+  return request(FRAME_PING, nullptr, 0, timeoutMs, status) &&
+         status == SERIAL_STATUS_OK;
+}
+
+bool SerialClient::keepAlive(int keepAliveMs) {
+  if (steadyMs() - lastRequestMs < keepAliveMs) {
+    return true;
+  }
+  uint8_t sequence;
+  return sendFrame(FRAME_PING, nullptr, 0, sequence);
+}
+
+bool SerialClient::sendCommand(
+    const MonitorCommand& command, int timeoutMs, uint8_t& status
+) {
+  return request(FRAME_COMMAND, &command, sizeof(command), timeoutMs, status);
+}
+
+bool SerialClient::request(
+    uint8_t type,
+    const void* payload,
+    size_t size,
+    int timeoutMs,
+    uint8_t& status
+) {
+  uint8_t sequence;
+  if (!sendFrame(type, payload, size, sequence)) {
+    return false;
+  }
+
+  int64_t deadline = steadyMs() + timeoutMs;
+  awaitingResponse = true;
+  hasResponse = false;
+  bool answered = false;
+  while (!answered) {
+    // Respostas atrasadas de pedidos anteriores são ignoradas
+    if (hasResponse) {
+      hasResponse = false;
+      answered = response.request_type == type &&
+                 response.request_sequence == sequence;
+      continue;
+    }
+    int64_t remaining = deadline - steadyMs();
+    if (remaining <= 0 || !receive(static_cast<int>(remaining))) {
+      break;
+    }
+  }
+  awaitingResponse = false;
+  if (answered) {
+    status = response.status;
+  }
+  return answered;
+}
+
+int SerialClient::readFrame(SerialFrame& frame, int timeoutMs) {
+  int64_t deadline = steadyMs() + timeoutMs;
+  while (pending.empty()) {
+    if (closed) {
+      return -1;
+    }
+    int64_t remaining = deadline - steadyMs();
+    if (remaining < 0) {
+      return 0;
+    }
+    receive(static_cast<int>(remaining));
+  }
+  frame = std::move(pending.front());
+  pending.pop_front();
+  return 1;
+}
+
+bool SerialClient::sendFrame(
+    uint8_t type, const void* payload, size_t size, uint8_t& sequence
+) {
+  uint8_t frame[serialFrameSize(sizeof(MonitorCommand))];
+  if (size > sizeof(MonitorCommand)) {
+    return false;
+  }
+  sequence = txSequence++;
+  size_t length = encodeFrame(type, sequence, payload, size, frame);
+  lastRequestMs = steadyMs();
+  return link->write(frame, length);
+}
+
+bool SerialClient::receive(int timeoutMs) {
+  ssize_t n = link->read(buffer, sizeof(buffer), timeoutMs);
+  if (n < 0) {
+    closed = true;
+    return false;
+  }
+  counters.bytesReceived += static_cast<size_t>(n);
+
+  int64_t arrivalUs = epochUs();
+  for (ssize_t i = 0; i < n; ++i) {
+    DecodeResult result = decoder->push(buffer[i]);
+    if (result == DecodeResult::TEXT) {
+      counters.textChunks++;
+      if (logHandler) {
+        logHandler(std::string(decoder->text(), decoder->textLength()));
+      }
+      continue;
+    }
+    if (result == DecodeResult::ERROR) {
+      counters.decodeErrors++;
+      continue;
+    }
+    if (result != DecodeResult::FRAME) {
+      continue;
+    }
+
+    counters.frames++;
+    // Todo quadro do dispositivo, respostas incluídas, avança a sequência
+    uint8_t sequence = decoder->sequence();
+    if (synced) {
+      counters.lostFrames += static_cast<uint8_t>(sequence - nextSequence);
+    }
+    synced = true;
+    nextSequence = sequence + 1;
+
+    if (decoder->type() == FRAME_RESPONSE) {
+      if (awaitingResponse && decoder->payloadSize() == sizeof(response)) {
+        memcpy(&response, decoder->payload(), sizeof(response));
+        hasResponse = true;
+      }
+      continue;
+    }
+    SerialFrame frame;
+    frame.type = decoder->type();
+    frame.sequence = sequence;
+    frame.timestampUs = arrivalUs;
+    frame.payload.assign(
+        decoder->payload(), decoder->payload() + decoder->payloadSize()
+    );
+    pending.push_back(std::move(frame));
+  }
+  return true;
+}
@@ -0,0 +1,151 @@
+#ifndef SERIAL_CLIENT_H
+#define SERIAL_CLIENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SensorData.h"
+#include "SerialProtocol.h"
+#include "Transport.h"
+
+/**
+ * @struct SerialFrame
+ * @brief A frame received from the device.
+ */
+struct SerialFrame {
+  uint8_t type;         // SerialFrameType
+  uint8_t sequence;
+  int64_t timestampUs;  // Chegada, em µs desde a época (relógio do host)
+  std::vector<uint8_t> payload;
+};
+
+/**
+ * @struct SerialClientStats
+ * @brief Receive counters since the client was created.
+ */
+struct SerialClientStats {
+  size_t bytesReceived = 0;
+  size_t frames = 0;
+  size_t decodeErrors = 0;  // Quadros com CRC ou COBS inválidos
+  size_t lostFrames = 0;    // Saltos na sequência do dispositivo
+  size_t textChunks = 0;    // Trechos de log entre quadros
+};
+
+/**
+ * @brief Copies a frame payload into a struct. Variable-length structs
+ * (MonitorBatch, RawSampleBlock) are accepted down to `minSize` bytes and
+ * the rest is zeroed.
+ * @return false if the payload is shorter than minSize or longer than T.
+ */
+template <typename T>
+bool payloadAs(
+    const SerialFrame& frame, T& value, size_t minSize = sizeof(T)
+) {
+  if (frame.payload.size() < minSize || frame.payload.size() > sizeof(T)) {
+    return false;
+  }
+  memset(&value, 0, sizeof(T));
+  memcpy(&value, frame.payload.data(), frame.payload.size());
+  return true;
+}
+
+/**
+ * @class SerialClient
+ * @brief Host side of the framed serial protocol (SerialProtocol.h).
+ *
+ * Wraps any Transport: serial:/dev/ttyUSB0 on the bench, a pty in the
+ * loopback test. Device frames that arrive while waiting for a response are
+ * queued for readFrame(), and the device logs printed between frames go to
+ * the log handler. Requests are only answered by the device, so keepAlive()
+ * must be called at least every SERIAL_HOST_TIMEOUT_MS (3 s) for the device
+ * to keep streaming.
+ */
+class SerialClient {
+ public:
+  explicit SerialClient(std::unique_ptr<Transport> transport);
+
+  /**
+   * @brief Called with each chunk of device log text. By default the text
+   * is discarded.
+   */
+  void setLogHandler(std::function<void(const std::string&)> handler);
+
+  /**
+   * @brief Sends a PING and waits for its response. The first successful
+   * ping attaches the host: the device only streams frames after it.
+   */
+  bool ping(int timeoutMs);
+
+  /**
+   * @brief Sends a PING without waiting if keepAliveMs have passed since the
+   * last request.
+   */
+  bool keepAlive(int keepAliveMs = 1000);
+
+  /**
+   * @brief Sends a MonitorCommand (sweep, monitoring or raw capture) and
+   * waits for its response.
+   * @param status Filled with the device SerialStatus.
+   * @return false on timeout or write error.
+   */
+  bool sendCommand(
+      const MonitorCommand& command, int timeoutMs, uint8_t& status
+  );
+
+  /**
+   * @brief Sends an arbitrary request and waits for its response. Lets the
+   * loopback test exercise the error answers.
+   */
+  bool request(
+      uint8_t type,
+      const void* payload,
+      size_t size,
+      int timeoutMs,
+      uint8_t& status
+  );
+
+  /**
+   * @brief Reads the next device frame (responses excluded).
+   * @return 1 if a frame was read, 0 on timeout, -1 if the link closed.
+   */
+  int readFrame(SerialFrame& frame, int timeoutMs);
+
+  const SerialClientStats& stats() const { return counters; }
+  const std::string& name() const { return link->name(); }
+
+ private:
+  std::unique_ptr<Transport> link;
+  std::unique_ptr<FrameDecoder<SERIAL_MAX_PAYLOAD>> decoder;
+  std::deque<SerialFrame> pending;
+  // Respostas dos PINGs de keepAlive() não são aguardadas e são ignoradas
+  bool awaitingResponse = false;
+  bool hasResponse = false;
+  SerialResponse response;
+  std::function<void(const std::string&)> logHandler;
+  SerialClientStats counters;
+  uint8_t txSequence = 0;
+  uint8_t nextSequence = 0;
+  bool synced = false;
+  bool closed = false;
+  int64_t lastRequestMs = 0;
+  uint8_t buffer[4096];
+
+  bool sendFrame(
+      uint8_t type, const void* payload, size_t size, uint8_t& sequence
+  );
+
+  /**
+   * @brief Reads from the transport once and decodes what arrived.
+   * @return false if the link closed.
+   */
+  bool receive(int timeoutMs);
+};
+
+#endif  // SERIAL_CLIENT_H
@@ -0,0 +1,222 @@
+#include "BenchReport.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+// O leitor só precisa entender o JSON escrito por writeReport(): uma chave
+// procurada dentro de uma linha
+bool findValue(const std::string& line, const char* key, size_t& pos) {
+  std::string quoted = std::string("\"") + key + "\":";
+  pos = line.find(quoted);
+  if (pos == std::string::npos) {
+    return false;
+  }
+  pos += quoted.size();
+  while (pos < line.size() && line[pos] == ' ') {
+    pos++;
+  }
+  return pos < line.size();
+}
+
+bool jsonNumber(const std::string& line, const char* key, double& value) {
+  size_t pos;
+  if (!findValue(line, key, pos)) {
+    return false;
+  }
+  char* end;
+  value = std::strtod(line.c_str() + pos, &end);
+  return end != line.c_str() + pos;
+}
+
+bool jsonString(const std::string& line, const char* key, std::string& value) {
+  size_t pos;
+  if (!findValue(line, key, pos) || line[pos] != '"') {
+    return false;
+  }
+  size_t close = line.find('"', pos + 1);
+  if (close == std::string::npos) {
+    return false;
+  }
+  value = line.substr(pos + 1, close - pos - 1);
+  return true;
+}
+
+}  // namespace
+
+void writeReport(std::FILE* out, const BenchReport& report) {
+  const BenchConfig& c = report.config;
+  std::fprintf(out, "{\n");
+  std::fprintf(
+      out,
+      "  \"config\": {\"readings\": %d, \"samples\": %d, \"trials\": %d, "
+      "\"sample_period_us\": %.3f, \"amplitude_v\": %.3f, \"seed\": %u},\n",
+      c.readings,
+      c.samples,
+      c.trials,
+      c.samplePeriodUs,
+      c.amplitudeV,
+      c.seed
+  );
+  std::fprintf(
+      out,
+      "  \"summary\": {\"samples_per_s\": %.0f, \"cycle_time_ms\": %.3f},\n",
+      report.samplesPerSecond,
+      report.cycleTimeMs
+  );
+  std::fprintf(out, "  \"results\": [\n");
+  for (size_t i = 0; i < report.results.size(); ++i) {
+    const ScenarioResult& r = report.results[i];
+    std::fprintf(
+        out,
+        "    {\"scenario\": \"%s\", \"frequency_hz\": %ld, \"bias\": %.6f, "
+        "\"std\": %.6f, \"reported_std\": %.6f, \"samples_per_s\": %.0f}%s\n",
+        r.scenario.c_str(),
+        r.frequencyHz,
+        r.bias,
+        r.std,
+        r.reportedStd,
+        r.samplesPerSecond,
+        i + 1 < report.results.size() ? "," : ""
+    );
+  }
+  std::fprintf(out, "  ]\n}\n");
+}
+
+bool readReport(const std::string& path, BenchReport& report) {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+
+  bool hasConfig = false;
+  bool hasSummary = false;
+  std::string line;
+  while (std::getline(in, line)) {
+    double value = 0.0;
+    if (line.find("\"config\"") != std::string::npos) {
+      BenchConfig& c = report.config;
+      hasConfig = jsonNumber(line, "readings", value);
+      c.readings = static_cast<int>(value);
+      hasConfig = hasConfig && jsonNumber(line, "samples", value);
+      c.samples = static_cast<int>(value);
+      hasConfig = hasConfig && jsonNumber(line, "trials", value);
+      c.trials = static_cast<int>(value);
+      hasConfig = hasConfig && jsonNumber(line, "sample_period_us", value);
+      c.samplePeriodUs = value;
+      hasConfig = hasConfig && jsonNumber(line, "amplitude_v", value);
+      c.amplitudeV = value;
+      hasConfig = hasConfig && jsonNumber(line, "seed", value);
+      c.seed = static_cast<unsigned>(value);
+    } else if (line.find("\"summary\"") != std::string::npos) {
+      hasSummary =
+          jsonNumber(line, "samples_per_s", report.samplesPerSecond) &&
+          jsonNumber(line, "cycle_time_ms", report.cycleTimeMs);
+    } else if (line.find("\"scenario\"") != std::string::npos) {
+      ScenarioResult r;
+      if (!jsonString(line, "scenario", r.scenario) ||
+          !jsonNumber(line, "frequency_hz", value) ||
+          !jsonNumber(line, "bias", r.bias) ||
+          !jsonNumber(line, "std", r.std)) {
+        return false;
+      }
+      r.frequencyHz = static_cast<long>(value);
+      jsonNumber(line, "reported_std", r.reportedStd);
+      jsonNumber(line, "samples_per_s", r.samplesPerSecond);
+      report.results.push_back(r);
+    }
+  }
+  return hasConfig && hasSummary;
+}
+
+std::vector<std::string> findRegressions(
+    const BenchReport& current,
+    const BenchReport& baseline,
+    const Tolerances& tolerances
+) {
+  std::vector<std::string> failures;
+  char message[256];
+
+  const BenchConfig& a = current.config;
+  const BenchConfig& b = baseline.config;
+  if (a.readings != b.readings || a.samples != b.samples ||
+      a.trials != b.trials || a.samplePeriodUs != b.samplePeriodUs ||
+      a.amplitudeV != b.amplitudeV || a.seed != b.seed) {
+    failures.push_back(
+        "configuration differs from the baseline; regenerate it with "
+        "--write-baseline"
+    );
+    return failures;
+  }
+
+  for (const ScenarioResult& base : baseline.results) {
+    const ScenarioResult* run = nullptr;
+    for (const ScenarioResult& r : current.results) {
+      if (r.scenario == base.scenario && r.frequencyHz == base.frequencyHz) {
+        run = &r;
+        break;
+      }
+    }
+    if (run == nullptr) {
+      std::snprintf(
+          message,
+          sizeof(message),
+          "%s @ %ld Hz: missing from this run",
+          base.scenario.c_str(),
+          base.frequencyHz
+      );
+      failures.push_back(message);
+      continue;
+    }
+
+    if (std::fabs(run->bias) > std::fabs(base.bias) + tolerances.accuracy) {
+      std::snprintf(
+          message,
+          sizeof(message),
+          "%s @ %ld Hz: |bias| %.6f exceeds baseline %.6f",
+          base.scenario.c_str(),
+          base.frequencyHz,
+          std::fabs(run->bias),
+          std::fabs(base.bias)
+      );
+      failures.push_back(message);
+    }
+    if (run->std > base.std + tolerances.accuracy) {
+      std::snprintf(
+          message,
+          sizeof(message),
+          "%s @ %ld Hz: std %.6f exceeds baseline %.6f",
+          base.scenario.c_str(),
+          base.frequencyHz,
+          run->std,
+          base.std
+      );
+      failures.push_back(message);
+    }
+  }
+  return failures;
+}
+
+std::string findSlowdown(
+    const BenchReport& current,
+    const BenchReport& baseline,
+    const Tolerances& tolerances
+) {
+  double minThroughput =
+      baseline.samplesPerSecond * (1.0 - tolerances.throughput);
+  if (current.samplesPerSecond >= minThroughput) {
+    return "";
+  }
+  char message[256];
+  std::snprintf(
+      message,
+      sizeof(message),
+      "throughput %.0f samples/s is below %.0f (baseline %.0f)",
+      current.samplesPerSecond,
+      minThroughput,
+      baseline.samplesPerSecond
+  );
+  return message;
+}
@@ -0,0 +1,86 @@
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Parameters that must match for two reports to be comparable.
+ */
+struct BenchConfig {
+  int readings = 20;    // READINGS_PER_POINT em src/main.cpp
+  int samples = 1024;   // SAMPLES_PER_READING em src/main.cpp
+  int trials = 8;       // Medições (fases aleatórias) por cenário e frequência
+  double samplePeriodUs = 8.0;
+  double amplitudeV = 0.5;
+  unsigned seed = 1;
+};
+
+/**
+ * @brief Accuracy of one scenario at one frequency, relative to the true
+ * amplitude.
+ */
+struct ScenarioResult {
+  std::string scenario;
+  long frequencyHz = 0;
+  double bias = 0.0;         // média(medido) / verdadeiro - 1
+  double std = 0.0;          // Desvio entre medições / verdadeiro
+  double reportedStd = 0.0;  // LockInResult::std_dev médio / verdadeiro
+  double samplesPerSecond = 0.0;
+};
+
+/**
+ * @brief Full benchmark output. Written as JSON with one result per line,
+ * which is also the stored baseline format.
+ */
+struct BenchReport {
+  BenchConfig config;
+  double samplesPerSecond = 0.0;  // Vazão da demodulação (todas as amostras)
+  double cycleTimeMs = 0.0;       // Demodulação de uma varredura completa
+  std::vector<ScenarioResult> results;
+};
+
+/**
+ * @brief Regression thresholds against a baseline.
+ */
+struct Tolerances {
+  double throughput = 0.25;  // Queda relativa máxima de amostras/s
+  double accuracy = 0.002;   // Piora absoluta máxima de |bias| e std
+  bool strictThroughput = false;  // Queda de vazão reprova a execução
+};
+
+void writeReport(std::FILE* out, const BenchReport& report);
+
+/**
+ * @brief Reads a report previously written by writeReport().
+ * @return false if the file cannot be read or is not a report.
+ */
+bool readReport(const std::string& path, BenchReport& report);
+
+/**
+ * @brief Compares the accuracy of a run against a baseline.
+ * @return One human-readable line per regression; empty if none.
+ */
+std::vector<std::string> findRegressions(
+    const BenchReport& current,
+    const BenchReport& baseline,
+    const Tolerances& tolerances
+);
+
+/**
+ * @brief Compares the throughput of a run against a baseline.
+ *
+ * Host wall-clock throughput depends on the machine and its load, so a
+ * drop is only a regression when the baseline was recorded on the same
+ * machine (Tolerances::strictThroughput).
+ * @return A human-readable line if throughput fell beyond the tolerance;
+ * empty otherwise.
+ */
+std::string findSlowdown(
+    const BenchReport& current,
+    const BenchReport& baseline,
+    const Tolerances& tolerances
+);
+
+#endif  // BENCH_REPORT_H
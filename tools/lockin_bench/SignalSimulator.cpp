@@ -0,0 +1,53 @@
+#include "SignalSimulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Intervalo de vTaskDelay(1) entre leituras no firmware (tick de 1 ms)
+const double YIELD_US = 1000.0;
+
+}  // namespace
+
+SimulatedStream SignalSimulator::generate(
+    const SignalSpec& spec,
+    long frequencyHz,
+    int numReadings,
+    int samplesPerReading
+) {
+  std::uniform_real_distribution<double> phaseDist(0.0, 2.0 * M_PI);
+  std::normal_distribution<double> noise(0.0, 1.0);
+
+  SimulatedStream stream;
+  stream.voltages.reserve(static_cast<size_t>(numReadings) * samplesPerReading);
+  stream.clockUs.reserve(
+      static_cast<size_t>(numReadings) * (samplesPerReading + 1)
+  );
+
+  const double omega = 2.0 * M_PI * frequencyHz * 1e-6;  // rad/µs
+  const double phase = phaseDist(rng);
+  // Instante real de cada evento; micros() só enxerga a parte inteira
+  double timeUs = std::uniform_real_distribution<double>(0.0, 1e6)(rng);
+
+  for (int i = 0; i < numReadings; ++i) {
+    stream.clockUs.push_back(static_cast<unsigned long>(timeUs));
+    for (int k = 0; k < samplesPerReading; ++k) {
+      double step = spec.samplePeriodUs + spec.jitterRmsUs * noise(rng);
+      timeUs += std::max(step, 0.1);
+
+      double v = spec.amplitudeV * std::sin(omega * timeUs + phase) +
+                 spec.dcOffsetV + spec.noiseRmsV * noise(rng);
+      if (spec.quantize) {
+        // Mesmo mapeamento de ENoseController::readVoltage()
+        double code = std::round(v / V_REF * 16384.0);
+        code = std::min(std::max(code, -16384.0), 16383.0);
+        v = code / 16384.0 * V_REF;
+      }
+      stream.voltages.push_back(static_cast<float>(v));
+      stream.clockUs.push_back(static_cast<unsigned long>(timeUs));
+    }
+    timeUs += YIELD_US;
+  }
+  return stream;
+}
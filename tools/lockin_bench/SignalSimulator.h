@@ -0,0 +1,68 @@
+#ifndef SIGNAL_SIMULATOR_H
+#define SIGNAL_SIMULATOR_H
+
+#include <random>
+#include <vector>
+
+/**
+ * @brief Impairments applied to the simulated sensor signal.
+ */
+struct SignalSpec {
+  double amplitudeV = 0.5;
+  double dcOffsetV = 0.0;
+  double noiseRmsV = 0.0;
+  bool quantize = false;        // Quantização do LTC2310 (±V_REF, 15 bits)
+  double samplePeriodUs = 8.0;  // Intervalo médio entre leituras do ADC
+  double jitterRmsUs = 0.0;     // Ruído no instante de cada amostra
+};
+
+/**
+ * @brief Pre-generated ADC stream for one call of measureLockIn().
+ *
+ * Samples and clock readings are produced in the order measureLockIn()
+ * consumes them (one clock reading before each block, then one after every
+ * sample), so replaying them costs two array reads and the timing measures
+ * only the demodulation.
+ */
+struct SimulatedStream {
+  std::vector<float> voltages;
+  std::vector<unsigned long> clockUs;  // Leituras de micros()
+
+  size_t nextVoltage = 0;
+  size_t nextClock = 0;
+
+  float readVoltage() { return voltages[nextVoltage++]; }
+  unsigned long nowUs() { return clockUs[nextClock++]; }
+  void rewind() { nextVoltage = nextClock = 0; }
+};
+
+/**
+ * @class SignalSimulator
+ * @brief Generates sine streams with known amplitude and phase as the
+ * firmware would read them through the LTC2310.
+ */
+class SignalSimulator {
+ public:
+  explicit SignalSimulator(unsigned seed) : rng(seed) { }
+
+  /**
+   * @brief Generates the stream for numReadings blocks of samplesPerReading
+   * samples at frequencyHz, with a random phase.
+   */
+  SimulatedStream generate(
+      const SignalSpec& spec,
+      long frequencyHz,
+      int numReadings,
+      int samplesPerReading
+  );
+
+  /**
+   * @brief ADC reference voltage; must match ENoseController::V_REF.
+   */
+  static constexpr double V_REF = 2.5;
+
+ private:
+  std::mt19937 rng;
+};
+
+#endif  // SIGNAL_SIMULATOR_H
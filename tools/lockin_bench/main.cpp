@@ -0,0 +1,280 @@
+/**
+ * @file main.cpp
+ * @brief Accuracy and throughput benchmark for the lock-in engine.
+ *
+ * Feeds measureLockIn() (lib/LockIn, the code behind
+ * ENoseController::performLockInMeasurement) with simulated ADC streams of
+ * known amplitude at every frequency of ActiveScan, under increasingly
+ * realistic impairments: quantization, noise and DC offset, timing jitter.
+ * Reports demodulation throughput, the host time of a full sweep and the
+ * amplitude bias and spread against ground truth as JSON, and exits with 1
+ * when accuracy falls behind a stored baseline by more than the tolerance.
+ * Throughput is host wall-clock time and varies between machines, so a drop
+ * is only reported as a warning unless --strict-throughput is given (for a
+ * baseline recorded on the same machine).
+ *
+ * Build and run from the repository root:
+ *   pio run -e lockin_bench
+ *   .pio/build/lockin_bench/program --baseline tools/lockin_bench/baseline.json
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "BenchReport.h"
+#include "LockIn.h"
+#include "SensorData.h"
+#include "SignalSimulator.h"
+
+namespace {
+
+struct Scenario {
+  const char* name;
+  SignalSpec spec;
+};
+
+// Cada cenário acrescenta uma degradação ao anterior
+std::vector<Scenario> makeScenarios(const BenchConfig& config) {
+  SignalSpec ideal;
+  ideal.amplitudeV = config.amplitudeV;
+  ideal.samplePeriodUs = config.samplePeriodUs;
+
+  SignalSpec quantized = ideal;
+  quantized.quantize = true;
+
+  SignalSpec noisy = quantized;
+  noisy.noiseRmsV = 0.010;
+  noisy.dcOffsetV = 0.200;
+
+  SignalSpec jitter = noisy;
+  jitter.jitterRmsUs = 1.0;
+
+  return {
+      {"ideal", ideal},
+      {"quantized", quantized},
+      {"noisy", noisy},
+      {"jitter", jitter},
+  };
+}
+
+// Cenário usado para o tempo de ciclo (o mais próximo do hardware)
+const char* CYCLE_SCENARIO = "jitter";
+
+// Cada medição é cronometrada algumas vezes e o menor tempo é mantido
+const int TIMING_REPEATS = 3;
+
+struct Options {
+  BenchConfig config;
+  Tolerances tolerances;
+  std::string output;
+  std::string baseline;
+  std::string writeBaseline;
+};
+
+void printUsage(const char* argv0) {
+  std::fprintf(
+      stderr,
+      "Usage: %s [--out FILE] [--baseline FILE] [--write-baseline FILE]\n"
+      "          [--readings N] [--samples N] [--trials N] [--seed N]\n"
+      "          [--sample-period-us US] [--throughput-tolerance F]\n"
+      "          [--accuracy-tolerance F] [--strict-throughput]\n"
+      "The JSON report goes to stdout unless --out is given.\n",
+      argv0
+  );
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--out" && hasValue) {
+      opts.output = argv[++i];
+    } else if (arg == "--baseline" && hasValue) {
+      opts.baseline = argv[++i];
+    } else if (arg == "--write-baseline" && hasValue) {
+      opts.writeBaseline = argv[++i];
+    } else if (arg == "--readings" && hasValue) {
+      opts.config.readings = std::atoi(argv[++i]);
+    } else if (arg == "--samples" && hasValue) {
+      opts.config.samples = std::atoi(argv[++i]);
+    } else if (arg == "--trials" && hasValue) {
+      opts.config.trials = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && hasValue) {
+      opts.config.seed = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (arg == "--sample-period-us" && hasValue) {
+      opts.config.samplePeriodUs = std::atof(argv[++i]);
+    } else if (arg == "--throughput-tolerance" && hasValue) {
+      opts.tolerances.throughput = std::atof(argv[++i]);
+    } else if (arg == "--accuracy-tolerance" && hasValue) {
+      opts.tolerances.accuracy = std::atof(argv[++i]);
+    } else if (arg == "--strict-throughput") {
+      opts.tolerances.strictThroughput = true;
+    } else {
+      return false;
+    }
+  }
+  return opts.config.readings > 0 && opts.config.samples > 0 &&
+         opts.config.trials > 1 && opts.config.samplePeriodUs > 0.0;
+}
+
+BenchReport runBenchmark(const BenchConfig& config) {
+  BenchReport report;
+  report.config = config;
+
+  SignalSimulator simulator(config.seed);
+  const double samplesPerMeasurement =
+      static_cast<double>(config.readings) * config.samples;
+  double totalSeconds = 0.0;
+  double totalSamples = 0.0;
+  double cycleSecondsPerPoint = 0.0;
+
+  for (const Scenario& scenario : makeScenarios(config)) {
+    for (long frequencyHz : ActiveScan::FREQUENCIES_HZ) {
+      std::vector<double> means;
+      double reportedStd = 0.0;
+      double seconds = 0.0;
+
+      for (int trial = 0; trial < config.trials; ++trial) {
+        SimulatedStream stream = simulator.generate(
+            scenario.spec, frequencyHz, config.readings, config.samples
+        );
+
+        LockInResult result = {0.0f, 0.0f};
+        double best = INFINITY;
+        for (int repeat = 0; repeat < TIMING_REPEATS; ++repeat) {
+          stream.rewind();
+          auto start = std::chrono::steady_clock::now();
+          result = measureLockIn(
+              frequencyHz,
+              config.readings,
+              config.samples,
+              [&stream]() { return stream.readVoltage(); },
+              [&stream]() { return stream.nowUs(); },
+              []() {}
+          );
+          best = std::min(
+              best,
+              std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - start
+              )
+                  .count()
+          );
+        }
+
+        means.push_back(result.mean);
+        reportedStd += result.std_dev;
+        seconds += best;
+      }
+
+      double sum = 0.0;
+      for (double m : means) {
+        sum += m;
+      }
+      double mean = sum / means.size();
+      double sumSq = 0.0;
+      for (double m : means) {
+        sumSq += (m - mean) * (m - mean);
+      }
+
+      ScenarioResult r;
+      r.scenario = scenario.name;
+      r.frequencyHz = frequencyHz;
+      r.bias = mean / config.amplitudeV - 1.0;
+      r.std = std::sqrt(sumSq / (means.size() - 1)) / config.amplitudeV;
+      r.reportedStd = reportedStd / config.trials / config.amplitudeV;
+      r.samplesPerSecond = samplesPerMeasurement * config.trials / seconds;
+      report.results.push_back(r);
+
+      totalSeconds += seconds;
+      totalSamples += samplesPerMeasurement * config.trials;
+      if (r.scenario == CYCLE_SCENARIO) {
+        cycleSecondsPerPoint +=
+            seconds / config.trials / ActiveScan::NUM_FREQUENCIES;
+      }
+    }
+  }
+
+  report.samplesPerSecond = totalSamples / totalSeconds;
+  // Todos os canais de uma frequência custam o mesmo para a demodulação
+  report.cycleTimeMs = cycleSecondsPerPoint * ADC_DATA_POINTS * 1000.0;
+  return report;
+}
+
+bool writeReportFile(const std::string& path, const BenchReport& report) {
+  std::FILE* f = std::fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    std::fprintf(stderr, "ERROR: cannot open %s\n", path.c_str());
+    return false;
+  }
+  writeReport(f, report);
+  std::fclose(f);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  BenchReport report = runBenchmark(opts.config);
+
+  if (opts.output.empty()) {
+    writeReport(stdout, report);
+  } else if (!writeReportFile(opts.output, report)) {
+    return 1;
+  }
+  if (!opts.writeBaseline.empty()) {
+    if (!writeReportFile(opts.writeBaseline, report)) {
+      return 1;
+    }
+    std::fprintf(
+        stderr, "Baseline written to %s\n", opts.writeBaseline.c_str()
+    );
+  }
+
+  std::fprintf(
+      stderr,
+      "%.1f Msamples/s, sweep demodulation %.1f ms\n",
+      report.samplesPerSecond / 1e6,
+      report.cycleTimeMs
+  );
+
+  if (opts.baseline.empty()) {
+    return 0;
+  }
+
+  BenchReport baseline;
+  if (!readReport(opts.baseline, baseline)) {
+    std::fprintf(
+        stderr, "ERROR: cannot read baseline %s\n", opts.baseline.c_str()
+    );
+    return 1;
+  }
+  std::vector<std::string> failures =
+      findRegressions(report, baseline, opts.tolerances);
+  std::string slowdown = findSlowdown(report, baseline, opts.tolerances);
+  if (!slowdown.empty() && opts.tolerances.strictThroughput) {
+    failures.push_back(slowdown);
+  } else if (!slowdown.empty()) {
+    std::fprintf(
+        stderr, "WARN: %s (advisory across machines)\n", slowdown.c_str()
+    );
+  }
+  for (const std::string& failure : failures) {
+    std::fprintf(stderr, "REGRESSION: %s\n", failure.c_str());
+  }
+  if (!failures.empty()) {
+    return 1;
+  }
+  std::fprintf(stderr, "No regression against %s\n", opts.baseline.c_str());
+  return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file main.cpp
+ * @brief Native receiver for DataPackets, replacing the per-packet pandas
+ * path of e-nose_client.py.
+ *
+ *   pio run -e receiver
+ *   .pio/build/receiver/program --source unix-listen:/tmp/enose.sock --csv out.csv
+ *   python src/e-nose_client.py --forward /tmp/enose.sock
+ *
+ * Every source carries the serial-link framing (lib/SerialProtocol); frames
+ * that fail the CRC are dropped and counted. Packets are timestamped as
+ * soon as they are decoded and written in batches (--batch packets or
+ * --flush-ms, whichever comes first) to a CSV with the client's columns
+ * and/or a columnar recording (.enr).
+ */
+
+#include <signal.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PacketDecoder.h"
+#include "PacketSink.h"
+#include "Transport.h"
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+void printUsage(const char* argv0) {
+  std::fprintf(
+      stderr,
+      "Usage: %s --source URI [--csv FILE] [--enr FILE] [--batch N]\n"
+      "          [--flush-ms MS] [--quiet]\n"
+      "URI: unix:PATH | unix-listen:PATH | tcp:HOST:PORT | tcp-listen:PORT |\n"
+      "     file:PATH | serial:PATH[@BAUD] | -\n",
+      argv0
+  );
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string source;
+  std::string csvPath;
+  std::string enrPath;
+  size_t batchSize = 32;
+  int flushMs = 1000;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--source" && hasValue) {
+      source = argv[++i];
+    } else if (arg == "--csv" && hasValue) {
+      csvPath = argv[++i];
+    } else if (arg == "--enr" && hasValue) {
+      enrPath = argv[++i];
+    } else if (arg == "--batch" && hasValue) {
+      batchSize = static_cast<size_t>(std::atoi(argv[++i]));
+    } else if (arg == "--flush-ms" && hasValue) {
+      flushMs = std::atoi(argv[++i]);
+    } else if (arg == "--quiet") {
+      quiet = true;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (source.empty()) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<PacketSink>> sinks;
+  if (!csvPath.empty()) {
+    std::unique_ptr<CsvPacketSink> sink(new CsvPacketSink(batchSize, flushMs));
+    if (!sink->open(csvPath)) {
+      std::fprintf(
+          stderr, "ERROR: %s: %s\n", csvPath.c_str(), sink->error().c_str()
+      );
+      return 1;
+    }
+    sinks.push_back(std::move(sink));
+  }
+  if (!enrPath.empty()) {
+    std::unique_ptr<RecordingPacketSink> sink(
+        new RecordingPacketSink(batchSize, flushMs)
+    );
+    if (!sink->open(enrPath)) {
+      std::fprintf(
+          stderr, "ERROR: %s: %s\n", enrPath.c_str(), sink->error().c_str()
+      );
+      return 1;
+    }
+    sinks.push_back(std::move(sink));
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  std::string error;
+  std::unique_ptr<Transport> transport = openTransport(source, error);
+  if (!transport) {
+    std::fprintf(stderr, "ERROR: %s: %s\n", source.c_str(), error.c_str());
+    return 1;
+  }
+  std::fprintf(stderr, "Receiving from %s\n", transport->name().c_str());
+
+  PacketAssembler assembler;
+  DataPacket packet;
+  uint8_t buffer[4096];
+  size_t bytesReceived = 0;
+  size_t packetsReceived = 0;
+  auto start = std::chrono::steady_clock::now();
+
+  while (!stopRequested) {
+    ssize_t n = transport->read(buffer, sizeof(buffer), 100);
+    if (n < 0) {
+      std::fprintf(stderr, "Source closed.\n");
+      break;
+    }
+    bytesReceived += static_cast<size_t>(n);
+    assembler.push(buffer, static_cast<size_t>(n));
+
+    while (assembler.next(packet)) {
+      int64_t arrivalUs = hostTimeUs();
+      packetsReceived++;
+      for (std::unique_ptr<PacketSink>& sink : sinks) {
+        if (!sink->append(arrivalUs, packet)) {
+          std::fprintf(stderr, "WARN: write failed\n");
+        }
+      }
+      if (!quiet) {
+        std::printf(
+            "Packet %zu: first ADC Mean %.4f\n", packetsReceived, packet.adc_mean[0]
+        );
+      }
+    }
+    for (std::unique_ptr<PacketSink>& sink : sinks) {
+      sink->poll();
+    }
+  }
+
+  for (std::unique_ptr<PacketSink>& sink : sinks) {
+    sink->flush();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start
+  )
+                       .count();
+  std::fprintf(
+      stderr,
+      "Received %zu packets (%zu bytes, %u corrupt frames) in %.3f s: "
+      "%.0f packets/s, %.2f MB/s\n",
+      packetsReceived,
+      bytesReceived,
+      static_cast<unsigned>(assembler.decodeErrors()),
+      seconds,
+      packetsReceived / seconds,
+      bytesReceived / seconds / 1e6
+  );
+  return 0;
+}
@@ -0,0 +1,374 @@
+/**
+ * @file main.cpp
+ * @brief Records the device output over the framed serial link, the lab
+ * alternative to BLE for calibration and bulk raw captures.
+ *
+ *   pio run -e serial_capture
+ *   .pio/build/serial_capture/program --port serial:/dev/ttyUSB0 --csv out.csv
+ *   .pio/build/serial_capture/program --port serial:/dev/ttyUSB0 \
+ *       --capture 0,23 --blocks 64 --raw raw.csv
+ *
+ * DataPackets go to the same CSV/.enr sinks as the receiver, monitoring
+ * batches and raw sample blocks to their own CSVs. The device logs printed
+ * between frames are copied to stderr. With --capture the device captures
+ * the requested blocks, returns to sweep mode and the tool exits once every
+ * block has arrived.
+ */
+
+#include <signal.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PacketSink.h"
+#include "SensorData.h"
+#include "SerialClient.h"
+#include "SerialProtocol.h"
+#include "Transport.h"
+
+namespace {
+
+const int REQUEST_TIMEOUT_MS = 1000;
+const int POLL_MS = 100;
+const float ADC_V_REF = 2.5f;  // Mesma referência de ENoseController
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+struct Options {
+  std::string port;
+  std::string csvPath;
+  std::string enrPath;
+  std::string rawPath;
+  std::string monitorPath;
+  std::vector<int> capturePoints;
+  std::vector<int> monitorPoints;
+  int blocks = 1;
+  int baselineS = 300;
+  double durationS = 0.0;
+  bool quiet = false;
+};
+
+void printUsage(const char* argv0) {
+  std::fprintf(
+      stderr,
+      "Usage: %s --port URI [--csv FILE] [--enr FILE] [--raw FILE]\n"
+      "          [--monitor-csv FILE] [--capture P[,P...] [--blocks N]]\n"
+      "          [--monitor P[,P...] [--baseline-s S]] [--duration S]\n"
+      "          [--quiet]\n"
+      "URI: serial:PATH[@BAUD] (default %d baud) or any receiver URI\n"
+      "P: point index in adc_mean (0..%d)\n",
+      argv0,
+      SERIAL_LINK_BAUD,
+      ADC_DATA_POINTS - 1
+  );
+}
+
+bool parsePoints(const std::string& text, std::vector<int>& points) {
+  size_t start = 0;
+  while (start <= text.size()) {
+    size_t comma = text.find(',', start);
+    std::string item = text.substr(
+        start, comma == std::string::npos ? std::string::npos : comma - start
+    );
+    char* end;
+    long point = std::strtol(item.c_str(), &end, 10);
+    if (item.empty() || *end != '\0' || point < 0 ||
+        point >= ADC_DATA_POINTS) {
+      return false;
+    }
+    points.push_back(static_cast<int>(point));
+    if (comma == std::string::npos) {
+      break;
+    }
+    start = comma + 1;
+  }
+  return !points.empty() && points.size() <= MAX_MONITOR_POINTS;
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--port" && hasValue) {
+      opts.port = argv[++i];
+    } else if (arg == "--csv" && hasValue) {
+      opts.csvPath = argv[++i];
+    } else if (arg == "--enr" && hasValue) {
+      opts.enrPath = argv[++i];
+    } else if (arg == "--raw" && hasValue) {
+      opts.rawPath = argv[++i];
+    } else if (arg == "--monitor-csv" && hasValue) {
+      opts.monitorPath = argv[++i];
+    } else if (arg == "--capture" && hasValue) {
+      if (!parsePoints(argv[++i], opts.capturePoints)) {
+        return false;
+      }
+    } else if (arg == "--blocks" && hasValue) {
+      opts.blocks = std::atoi(argv[++i]);
+    } else if (arg == "--monitor" && hasValue) {
+      if (!parsePoints(argv[++i], opts.monitorPoints)) {
+        return false;
+      }
+    } else if (arg == "--baseline-s" && hasValue) {
+      opts.baselineS = std::atoi(argv[++i]);
+    } else if (arg == "--duration" && hasValue) {
+      opts.durationS = std::atof(argv[++i]);
+    } else if (arg == "--quiet") {
+      opts.quiet = true;
+    } else {
+      return false;
+    }
+  }
+  return !opts.port.empty() && opts.blocks > 0 && opts.blocks <= 0xFFFF &&
+         opts.baselineS >= 0 && opts.baselineS <= 0xFFFF &&
+         (opts.capturePoints.empty() || opts.monitorPoints.empty());
+}
+
+FILE* openCsv(const std::string& path, const char* header) {
+  FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    std::fprintf(stderr, "ERROR: cannot open %s\n", path.c_str());
+  } else {
+    std::fprintf(file, "%s\n", header);
+  }
+  return file;
+}
+
+MonitorCommand makeCommand(const Options& opts) {
+  MonitorCommand command = {};
+  const std::vector<int>& points =
+      opts.capturePoints.empty() ? opts.monitorPoints : opts.capturePoints;
+  command.mode = opts.capturePoints.empty() ? MODE_MONITOR : MODE_RAW_CAPTURE;
+  command.num_points = static_cast<uint8_t>(points.size());
+  command.baseline_interval_s = static_cast<uint16_t>(opts.baselineS);
+  for (size_t i = 0; i < points.size(); ++i) {
+    command.points[i] = static_cast<uint8_t>(points[i]);
+  }
+  command.raw_blocks = static_cast<uint16_t>(opts.blocks);
+  return command;
+}
+
+void writeRawBlock(FILE* file, const RawSampleBlock& block) {
+  long frequencyHz = ActiveScan::frequencyOfPoint(block.point);
+  int channel = ActiveScan::channelOfPoint(block.point);
+  double periodUs =
+      block.count > 1 ? (double) block.duration_us / (block.count - 1) : 0.0;
+  for (int k = 0; k < block.count; ++k) {
+    std::fprintf(
+        file,
+        "%u,%u,%ld,%d,%d,%.1f,%d,%.6f\n",
+        block.sequence,
+        block.point,
+        frequencyHz,
+        channel,
+        k,
+        block.start_us + k * periodUs,
+        block.samples[k],
+        block.samples[k] / 16384.0f * ADC_V_REF
+    );
+  }
+}
+
+void writeMonitorBatch(FILE* file, const MonitorBatch& batch) {
+  for (int i = 0; i < batch.count && i < MONITOR_BATCH_SIZE; ++i) {
+    const MonitorSample& s = batch.samples[i];
+    std::fprintf(
+        file,
+        "%u,%u,%u,%.6f,%.6f\n",
+        batch.sequence,
+        s.timestamp_us,
+        s.point,
+        s.amplitude,
+        s.phase
+    );
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<PacketSink>> sinks;
+  if (!opts.csvPath.empty()) {
+    std::unique_ptr<CsvPacketSink> sink(new CsvPacketSink(32, 1000));
+    if (!sink->open(opts.csvPath)) {
+      std::fprintf(stderr, "ERROR: cannot open %s\n", opts.csvPath.c_str());
+      return 1;
+    }
+    sinks.push_back(std::move(sink));
+  }
+  if (!opts.enrPath.empty()) {
+    std::unique_ptr<RecordingPacketSink> sink(
+        new RecordingPacketSink(32, 1000)
+    );
+    if (!sink->open(opts.enrPath)) {
+      std::fprintf(
+          stderr,
+          "ERROR: %s: %s\n",
+          opts.enrPath.c_str(),
+          sink->error().c_str()
+      );
+      return 1;
+    }
+    sinks.push_back(std::move(sink));
+  }
+  FILE* rawFile = nullptr;
+  if (!opts.rawPath.empty()) {
+    rawFile = openCsv(
+        opts.rawPath,
+        "Block,Point,Frequency_Hz,Channel,Sample,Time_us,Code,Voltage"
+    );
+    if (rawFile == nullptr) {
+      return 1;
+    }
+  }
+  FILE* monitorFile = nullptr;
+  if (!opts.monitorPath.empty()) {
+    monitorFile =
+        openCsv(opts.monitorPath, "Batch,Timestamp_us,Point,Amplitude,Phase");
+    if (monitorFile == nullptr) {
+      return 1;
+    }
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  std::string error;
+  std::unique_ptr<Transport> transport = openTransport(opts.port, error);
+  if (!transport) {
+    std::fprintf(stderr, "ERROR: %s: %s\n", opts.port.c_str(), error.c_str());
+    return 1;
+  }
+  SerialClient client(std::move(transport));
+  if (!opts.quiet) {
+    client.setLogHandler([](const std::string& text) {
+      std::fwrite(text.data(), 1, text.size(), stderr);
+    });
+  }
+  if (!client.ping(REQUEST_TIMEOUT_MS)) {
+    std::fprintf(stderr, "ERROR: no answer from %s\n", client.name().c_str());
+    return 1;
+  }
+  std::fprintf(stderr, "Attached to %s\n", client.name().c_str());
+
+  size_t expectedBlocks = 0;
+  if (!opts.capturePoints.empty() || !opts.monitorPoints.empty()) {
+    uint8_t status = 0;
+    if (!client.sendCommand(makeCommand(opts), REQUEST_TIMEOUT_MS, status) ||
+        status != SERIAL_STATUS_OK) {
+      std::fprintf(stderr, "ERROR: command refused (status %u)\n", status);
+      return 1;
+    }
+    expectedBlocks = opts.capturePoints.size() * opts.blocks;
+  }
+
+  size_t packets = 0;
+  size_t rawBlocks = 0;
+  size_t batches = 0;
+  auto start = std::chrono::steady_clock::now();
+  SerialFrame frame;
+  while (!stopRequested) {
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start
+    )
+                         .count();
+    if ((opts.durationS > 0.0 && elapsed >= opts.durationS) ||
+        (expectedBlocks > 0 && rawBlocks >= expectedBlocks)) {
+      break;
+    }
+
+    client.keepAlive();
+    int rc = client.readFrame(frame, POLL_MS);
+    if (rc < 0) {
+      std::fprintf(stderr, "Port closed.\n");
+      break;
+    }
+    if (rc > 0) {
+      switch (frame.type) {
+        case FRAME_DATA_PACKET: {
+          DataPacket packet;
+          if (payloadAs(frame, packet)) {
+            packets++;
+            for (std::unique_ptr<PacketSink>& sink : sinks) {
+              sink->append(frame.timestampUs, packet);
+            }
+          }
+          break;
+        }
+        case FRAME_RAW_SAMPLES: {
+          static RawSampleBlock block;
+          if (payloadAs(frame, block, offsetof(RawSampleBlock, samples))) {
+            rawBlocks++;
+            if (rawFile != nullptr) {
+              writeRawBlock(rawFile, block);
+            }
+          }
+          break;
+        }
+        case FRAME_MONITOR_BATCH: {
+          MonitorBatch batch;
+          if (payloadAs(frame, batch, offsetof(MonitorBatch, samples))) {
+            batches++;
+            if (monitorFile != nullptr) {
+              writeMonitorBatch(monitorFile, batch);
+            }
+          }
+          break;
+        }
+        case FRAME_CLASSIFICATION: {
+          OdorClassification classification;
+          if (!opts.quiet && payloadAs(frame, classification)) {
+            std::printf(
+                "Classification: packet %lu label %u (confidence %u/255)\n",
+                (unsigned long) classification.sequence,
+                classification.label,
+                classification.confidence
+            );
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    for (std::unique_ptr<PacketSink>& sink : sinks) {
+      sink->poll();
+    }
+  }
+
+  for (std::unique_ptr<PacketSink>& sink : sinks) {
+    sink->flush();
+  }
+  if (rawFile != nullptr) {
+    std::fclose(rawFile);
+  }
+  if (monitorFile != nullptr) {
+    std::fclose(monitorFile);
+  }
+
+  const SerialClientStats& stats = client.stats();
+  std::fprintf(
+      stderr,
+      "%zu packets, %zu monitor batches, %zu raw blocks; %zu bytes, "
+      "%zu frames lost, %zu decode errors\n",
+      packets,
+      batches,
+      rawBlocks,
+      stats.bytesReceived,
+      stats.lostFrames,
+      stats.decodeErrors
+  );
+  return expectedBlocks > 0 && rawBlocks < expectedBlocks ? 1 : 0;
+}
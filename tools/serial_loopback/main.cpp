@@ -0,0 +1,400 @@
+/**
+ * @file main.cpp
+ * @brief Loopback test of the framed serial protocol over a pseudo-terminal.
+ *
+ * A simulated device on the pty master answers requests like SerialLink
+ * (lib/SerialLink) and streams raw sample blocks and DataPackets with known
+ * contents, interleaved with text log lines and, optionally, corrupted
+ * frames. The host side is SerialClient (tools/lib/SerialClient) on the pty
+ * slave, opened through the same serial: URI as a real board. Checks the
+ * error answers, that every intact frame arrives with its exact contents,
+ * that each corrupted frame is rejected and counted as lost, and that the
+ * logs are passed through; then reports the throughput. Exits with 1 if any
+ * check fails.
+ *
+ * Build and run from the repository root:
+ *   pio run -e serial_loopback
+ *   .pio/build/serial_loopback/program [--blocks N] [--corrupt-every N]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SensorData.h"
+#include "SerialClient.h"
+#include "SerialProtocol.h"
+#include "Transport.h"
+
+namespace {
+
+// Pontos da captura pedida pelo host
+const uint8_t CAPTURE_POINTS[] = {0, ADC_DATA_POINTS - 1};
+const size_t NUM_CAPTURE_POINTS = sizeof(CAPTURE_POINTS);
+
+// Um DataPacket e uma linha de log a cada DATA_EVERY blocos
+const int DATA_EVERY = 4;
+
+const int REQUEST_TIMEOUT_MS = 1000;
+const int IDLE_TIMEOUT_MS = 2000;
+const int POLL_MS = 50;
+
+struct Options {
+  int blocks = 64;        // Blocos por ponto
+  int corruptEvery = 7;   // Corrompe um quadro a cada N (0 = nenhum)
+};
+
+// Conteúdo conhecido: cobre todos os bytes, inclusive zeros (COBS)
+int16_t samplePattern(uint32_t sequence, int k) {
+  uint32_t value = (sequence * 7919u + k * 31u) & 0xFFFF;
+  return static_cast<int16_t>(static_cast<int32_t>(value) - 32768);
+}
+
+float packetPattern(uint32_t sequence, int index) {
+  return sequence + index * 0.25f;
+}
+
+/**
+ * @brief Simulated device: the request handling of SerialLink plus the
+ * streaming of a raw capture.
+ */
+class SimulatedDevice {
+ public:
+  SimulatedDevice(Transport& port, const Options& opts)
+      : port(port), opts(opts) { }
+
+  void run() {
+    uint8_t buffer[256];
+    while (!stopRequested) {
+      ssize_t n = port.read(buffer, sizeof(buffer), 10);
+      if (n < 0) {
+        break;
+      }
+      for (ssize_t i = 0; i < n; ++i) {
+        if (decoder.push(buffer[i]) == DecodeResult::FRAME) {
+          handleFrame();
+        }
+      }
+      if (captureRequested) {
+        captureRequested = false;
+        streamCapture();
+      }
+    }
+  }
+
+  void stop() { stopRequested = true; }
+  int corruptedFrames() const { return corrupted; }
+  int corruptedBlocks() const { return corruptedRaw; }
+
+ private:
+  Transport& port;
+  const Options& opts;
+  FrameDecoder<sizeof(MonitorCommand)> decoder;
+  std::atomic<bool> stopRequested{false};
+  bool attached = false;
+  bool captureRequested = false;
+  MonitorCommand command = {};
+  uint8_t txSequence = 0;
+  int framesSent = 0;
+  // Lidos pela thread do host durante a transmissão
+  std::atomic<int> corrupted{0};
+  std::atomic<int> corruptedRaw{0};
+  std::vector<uint8_t> frame =
+      std::vector<uint8_t>(serialFrameSize(SERIAL_MAX_PAYLOAD));
+
+  // Mesma lógica de SerialLink::handleFrame()
+  void handleFrame() {
+    attached = true;
+    SerialResponse response = {decoder.type(), decoder.sequence(), 0};
+    if (decoder.type() == FRAME_COMMAND) {
+      size_t size = decoder.payloadSize();
+      if (size == 0 || size > sizeof(MonitorCommand)) {
+        response.status = SERIAL_STATUS_BAD_LENGTH;
+      } else {
+        command = {};
+        memcpy(&command, decoder.payload(), size);
+        captureRequested = command.mode == MODE_RAW_CAPTURE;
+      }
+    } else if (decoder.type() != FRAME_PING) {
+      response.status = SERIAL_STATUS_UNKNOWN_TYPE;
+    }
+    send(FRAME_RESPONSE, &response, sizeof(response), false);
+  }
+
+  bool send(uint8_t type, const void* payload, size_t size, bool mayCorrupt) {
+    if (!attached) {
+      return false;
+    }
+    size_t length =
+        encodeFrame(type, txSequence++, payload, size, frame.data());
+    framesSent++;
+    if (mayCorrupt && opts.corruptEvery > 0 &&
+        framesSent % opts.corruptEvery == 0) {
+      // Um byte no meio do quadro; nunca vira delimitador
+      uint8_t& byte = frame[length / 2];
+      byte ^= (byte ^ 0x55) != 0 ? 0x55 : 0xAA;
+      corrupted++;
+      corruptedRaw += type == FRAME_RAW_SAMPLES;
+    }
+    return port.write(frame.data(), length);
+  }
+
+  void log(const std::string& line) {
+    port.write(reinterpret_cast<const uint8_t*>(line.data()), line.size());
+  }
+
+  void streamCapture() {
+    static RawSampleBlock block;
+    uint32_t blockSequence = 0;
+    uint32_t packetSequence = 0;
+    uint16_t numBlocks = command.raw_blocks > 0 ? command.raw_blocks : 1;
+    for (uint8_t i = 0; i < command.num_points; ++i) {
+      log(
+          "Capturing " + std::to_string(numBlocks) +
+          " raw block(s) at point " + std::to_string(command.points[i]) + "\n"
+      );
+      for (uint16_t b = 0; b < numBlocks; ++b) {
+        block.sequence = blockSequence++;
+        block.start_us = block.sequence * 10000;
+        block.duration_us = 9000;
+        block.point = command.points[i];
+        block.count = RAW_BLOCK_SAMPLES;
+        for (int k = 0; k < RAW_BLOCK_SAMPLES; ++k) {
+          block.samples[k] = samplePattern(block.sequence, k);
+        }
+        send(FRAME_RAW_SAMPLES, &block, sizeof(block), true);
+
+        if (block.sequence % DATA_EVERY == 0) {
+          DataPacket packet = {};
+          packet.sequence = packetSequence++;
+          packet.timestamp_ms = block.start_us / 1000;
+          for (int p = 0; p < ADC_DATA_POINTS; ++p) {
+            packet.adc_mean[p] = packetPattern(packet.sequence, p);
+          }
+          send(FRAME_DATA_PACKET, &packet, sizeof(packet), true);
+          log("--- Cycle finished in 9 ms ---\n");
+        }
+      }
+    }
+  }
+};
+
+bool checkBlock(const RawSampleBlock& block, int blocksPerPoint) {
+  if (block.count != RAW_BLOCK_SAMPLES) {
+    return false;
+  }
+  for (int k = 0; k < RAW_BLOCK_SAMPLES; ++k) {
+    if (block.samples[k] != samplePattern(block.sequence, k)) {
+      return false;
+    }
+  }
+  uint32_t index = block.sequence / blocksPerPoint;
+  return index < NUM_CAPTURE_POINTS && block.point == CAPTURE_POINTS[index];
+}
+
+bool checkPacket(const DataPacket& packet) {
+  for (int p = 0; p < ADC_DATA_POINTS; ++p) {
+    if (packet.adc_mean[p] != packetPattern(packet.sequence, p)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--blocks" && hasValue) {
+      opts.blocks = std::atoi(argv[++i]);
+    } else if (arg == "--corrupt-every" && hasValue) {
+      opts.corruptEvery = std::atoi(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  return opts.blocks > 0 && opts.blocks <= 0xFFFF && opts.corruptEvery >= 0;
+}
+
+bool expect(bool condition, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL: %s\n", what);
+  }
+  return condition;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    std::fprintf(
+        stderr, "Usage: %s [--blocks N] [--corrupt-every N]\n", argv[0]
+    );
+    return 1;
+  }
+
+  std::string slavePath;
+  std::string error;
+  std::unique_ptr<Transport> master = openPtyMaster(slavePath, error);
+  if (!master) {
+    std::fprintf(stderr, "ERROR: %s\n", error.c_str());
+    return 1;
+  }
+  std::string uri =
+      "serial:" + slavePath + "@" + std::to_string(SERIAL_LINK_BAUD);
+  std::unique_ptr<Transport> slave = openTransport(uri, error);
+  if (!slave) {
+    std::fprintf(stderr, "ERROR: %s: %s\n", uri.c_str(), error.c_str());
+    return 1;
+  }
+
+  SimulatedDevice device(*master, opts);
+  std::thread deviceThread([&device]() { device.run(); });
+
+  SerialClient client(std::move(slave));
+  std::string logs;
+  client.setLogHandler([&logs](const std::string& text) { logs += text; });
+
+  bool ok = true;
+  uint8_t status = 0xFF;
+  ok = expect(client.ping(REQUEST_TIMEOUT_MS), "no answer to PING") && ok;
+  ok = expect(
+           client.request(
+               FRAME_COMMAND, nullptr, 0, REQUEST_TIMEOUT_MS, status
+           ) && status == SERIAL_STATUS_BAD_LENGTH,
+           "empty command not refused with BAD_LENGTH"
+       ) &&
+       ok;
+  ok = expect(
+           client.request(0x7F, nullptr, 0, REQUEST_TIMEOUT_MS, status) &&
+               status == SERIAL_STATUS_UNKNOWN_TYPE,
+           "unknown request not refused with UNKNOWN_TYPE"
+       ) &&
+       ok;
+
+  MonitorCommand command = {};
+  command.mode = MODE_RAW_CAPTURE;
+  command.num_points = NUM_CAPTURE_POINTS;
+  for (size_t i = 0; i < NUM_CAPTURE_POINTS; ++i) {
+    command.points[i] = CAPTURE_POINTS[i];
+  }
+  command.raw_blocks = static_cast<uint16_t>(opts.blocks);
+  ok = expect(
+           client.sendCommand(command, REQUEST_TIMEOUT_MS, status) &&
+               status == SERIAL_STATUS_OK,
+           "raw capture command not accepted"
+       ) &&
+       ok;
+
+  const int totalBlocks = opts.blocks * NUM_CAPTURE_POINTS;
+  const int totalPackets = (totalBlocks + DATA_EVERY - 1) / DATA_EVERY;
+  int rawBlocks = 0;
+  int packets = 0;
+  int badContents = 0;
+  size_t payloadBytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto last = start;
+
+  SerialFrame frame;
+  while (rawBlocks + packets + device.corruptedFrames() <
+         totalBlocks + totalPackets) {
+    client.keepAlive();
+    // Espera curta: quadros corrompidos só aparecem no contador do
+    // dispositivo
+    int rc = client.readFrame(frame, POLL_MS);
+    if (rc == 0 && std::chrono::steady_clock::now() - last <
+                       std::chrono::milliseconds(IDLE_TIMEOUT_MS)) {
+      continue;
+    }
+    if (rc <= 0) {
+      std::fprintf(stderr, "FAIL: stream stopped\n");
+      ok = false;
+      break;
+    }
+    last = std::chrono::steady_clock::now();
+    payloadBytes += frame.payload.size();
+    if (frame.type == FRAME_RAW_SAMPLES) {
+      static RawSampleBlock block;
+      rawBlocks++;
+      if (!payloadAs(frame, block, offsetof(RawSampleBlock, samples)) ||
+          !checkBlock(block, opts.blocks)) {
+        badContents++;
+      }
+    } else if (frame.type == FRAME_DATA_PACKET) {
+      DataPacket packet;
+      packets++;
+      if (!payloadAs(frame, packet) || !checkPacket(packet)) {
+        badContents++;
+      }
+    } else {
+      badContents++;
+    }
+  }
+
+  // A resposta avança a sequência: quadros corrompidos no fim também
+  // aparecem como perdidos
+  ok = expect(client.ping(REQUEST_TIMEOUT_MS), "no answer after the stream") &&
+       ok;
+  device.stop();
+  deviceThread.join();
+
+  const SerialClientStats& stats = client.stats();
+  int corrupted = device.corruptedFrames();
+  ok = expect(badContents == 0, "frame contents differ from what was sent") &&
+       ok;
+  ok = expect(
+           rawBlocks == totalBlocks - device.corruptedBlocks(),
+           "raw blocks missing"
+       ) &&
+       ok;
+  ok = expect(
+           stats.decodeErrors == static_cast<size_t>(corrupted),
+           "corrupted frames not all rejected"
+       ) &&
+       ok;
+  ok = expect(
+           stats.lostFrames == static_cast<size_t>(corrupted),
+           "lost frames not detected from the sequence"
+       ) &&
+       ok;
+  ok = expect(
+           logs.find("Capturing") != std::string::npos &&
+               logs.find("Cycle finished") != std::string::npos,
+           "device logs not passed through"
+       ) &&
+       ok;
+
+  double seconds = std::chrono::duration<double>(last - start).count();
+  // 8N1: 10 bits por byte na UART
+  double linkBytesPerS = SERIAL_LINK_BAUD / 10.0;
+  double frameBytes = serialFrameSize(sizeof(RawSampleBlock));
+  std::printf(
+      "%d raw blocks, %d packets, %d corrupted frames rejected, %zu log "
+      "chunks\n",
+      rawBlocks,
+      packets,
+      corrupted,
+      stats.textChunks
+  );
+  std::printf(
+      "pty: %.2f MB/s of payload (%zu bytes in %.3f s)\n",
+      payloadBytes / seconds / 1e6,
+      payloadBytes,
+      seconds
+  );
+  std::printf(
+      "At %d baud: %.1f raw blocks/s, %.0f ADC samples/s\n",
+      SERIAL_LINK_BAUD,
+      linkBytesPerS / frameBytes,
+      linkBytesPerS / frameBytes * RAW_BLOCK_SAMPLES
+  );
+
+  std::fprintf(stderr, ok ? "All checks passed\n" : "Some checks failed\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file main.cpp
+ * @brief Simulated E-Nose: replays recorded packets over any Transport so
+ * the receiver can be tested and benchmarked without BLE hardware.
+ *
+ *   pio run -e simulator
+ *   .pio/build/simulator/program --input session.enr --pty
+ *   .pio/build/simulator/program --input session.enr --target unix:/tmp/enose.sock
+ *
+ * Recordings come from the receiver's --enr output or from csv2rec. Packets
+ * are framed as on the serial link (lib/SerialProtocol). With --rate 0
+ * packets are sent as fast as the transport accepts them.
+ * --drop-every N skips every Nth packet to exercise loss accounting, and
+ * --corrupt-every N damages a byte of every Nth frame to exercise the
+ * receiver's resynchronization.
+ */
+
+#include <poll.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RecordingReader.h"
+#include "SensorData.h"
+#include "SerialProtocol.h"
+#include "Transport.h"
+
+namespace {
+
+bool loadPackets(const std::string& path, std::vector<DataPacket>& packets) {
+  RecordingReader reader;
+  if (!reader.open(path)) {
+    std::fprintf(stderr, "ERROR: %s: %s\n", path.c_str(), reader.error().c_str());
+    return false;
+  }
+  if (reader.columnNames().size() != NUM_PACKET_VALUES) {
+    std::fprintf(
+        stderr, "ERROR: %s does not match the firmware DataPacket\n", path.c_str()
+    );
+    return false;
+  }
+
+  for (size_t b = 0; b < reader.blockCount(); ++b) {
+    const RecordingBlock& block = reader.block(b);
+    for (uint32_t r = 0; r < block.rowCount; ++r) {
+      DataPacket packet = {};
+      float* values = packetValues(packet);
+      for (size_t c = 0; c < NUM_PACKET_VALUES; ++c) {
+        values[c] = block.columns[c][r];
+      }
+      packets.push_back(packet);
+    }
+  }
+  return !packets.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string input;
+  std::string target;
+  bool usePty = false;
+  double rateHz = 10.0;
+  size_t count = 0;  // 0 = uma passagem pela gravação
+  size_t dropEvery = 0;
+  size_t corruptEvery = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--input" && hasValue) {
+      input = argv[++i];
+    } else if (arg == "--target" && hasValue) {
+      target = argv[++i];
+    } else if (arg == "--pty") {
+      usePty = true;
+    } else if (arg == "--rate" && hasValue) {
+      rateHz = std::atof(argv[++i]);
+    } else if (arg == "--count" && hasValue) {
+      count = static_cast<size_t>(std::atoll(argv[++i]));
+    } else if (arg == "--drop-every" && hasValue) {
+      dropEvery = static_cast<size_t>(std::atoll(argv[++i]));
+    } else if (arg == "--corrupt-every" && hasValue) {
+      corruptEvery = static_cast<size_t>(std::atoll(argv[++i]));
+    } else {
+      input.clear();
+      break;
+    }
+  }
+  if (input.empty() || (target.empty() == !usePty)) {
+    std::fprintf(
+        stderr,
+        "Usage: %s --input FILE.enr (--target URI | --pty) [--rate HZ]"
+        " [--count N] [--drop-every N] [--corrupt-every N]\n",
+        argv[0]
+    );
+    return 1;
+  }
+
+  std::vector<DataPacket> packets;
+  if (!loadPackets(input, packets)) {
+    return 1;
+  }
+  if (count == 0) {
+    count = packets.size();
+  }
+
+  std::string error;
+  std::unique_ptr<Transport> transport;
+  if (usePty) {
+    std::string slavePath;
+    transport = openPtyMaster(slavePath, error);
+    if (transport) {
+      std::printf("%s\n", slavePath.c_str());
+      std::fflush(stdout);
+      // O mestre do pty sinaliza POLLHUP até o receptor abrir o escravo;
+      // esperar evita perder os primeiros pacotes
+      pollfd pfd = {transport->fd(), POLLOUT, 0};
+      while (::poll(&pfd, 1, 10) >= 0 && (pfd.revents & POLLHUP)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+  } else {
+    transport = openTransport(target, error);
+  }
+  if (!transport) {
+    std::fprintf(stderr, "ERROR: %s\n", error.c_str());
+    return 1;
+  }
+
+  auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(rateHz > 0 ? 1.0 / rateHz : 0.0)
+  );
+  uint8_t frame[serialFrameSize(sizeof(DataPacket))];
+  auto start = std::chrono::steady_clock::now();
+  auto next = start;
+  for (size_t i = 0; i < count; ++i) {
+    if (rateHz > 0) {
+      std::this_thread::sleep_until(next);
+      next += period;
+    }
+    // Cabeçalho preenchido como o firmware faz: ciclo e millis() do "boot"
+    DataPacket packet = packets[i % packets.size()];
+    packet.sequence = static_cast<uint32_t>(i);
+    packet.timestamp_ms = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start
+        )
+            .count()
+    );
+    if (dropEvery > 0 && (i + 1) % dropEvery == 0) {
+      continue;  // Simula um pacote perdido no enlace
+    }
+    size_t length = encodeFrame(
+        FRAME_DATA_PACKET, static_cast<uint8_t>(i), &packet, sizeof(packet), frame
+    );
+    if (corruptEvery > 0 && (i + 1) % corruptEvery == 0) {
+      frame[length / 2] ^= 0x5A;  // Ruído na linha; o CRC deve rejeitar
+    }
+    if (!transport->write(frame, length)) {
+      std::fprintf(stderr, "ERROR: peer closed after %zu packets\n", i);
+      return 1;
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start
+  )
+                       .count();
+  if (usePty) {
+    // Fechar o mestre descarta o que o escravo ainda não leu
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  }
+  std::fprintf(
+      stderr, "Sent %zu packets in %.3f s (%.0f packets/s)\n", count, seconds,
+      count / seconds
+  );
+  return 0;
+}
@@ -0,0 +1,193 @@
+#include "Dataset.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "Parallel.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Sem cabeçalho, as linhas do e-nose_client.py terminam sempre com
+// adc_mean e adc_std_dev do DataPacket; o prefixo variou (Sequence e
+// Device_ms foram acrescentados), então as médias são localizadas a partir
+// do fim da linha
+const size_t HEADERLESS_TRAILING_COLUMNS = 2 * ADC_DATA_POINTS;
+
+struct ParsedFile {
+  std::vector<Sample> samples;
+  size_t bytes = 0;
+  bool skipped = false;
+  std::string reason;
+};
+
+int labelFromFileName(const std::string& stem) {
+  std::string prefix = stem.substr(0, stem.find('_'));
+  for (size_t i = 0; i < CLASS_NAMES.size(); ++i) {
+    if (prefix == CLASS_NAMES[i]) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+std::string meanColumnName(int dataIndex) {
+  int freq = dataIndex / NUM_CANAIS;
+  int ch = dataIndex % NUM_CANAIS + 1;
+  return "Ch" + std::to_string(ch) + "_F" +
+         std::to_string(ActiveScan::FREQUENCIES_HZ[freq]) + "Hz_Mean";
+}
+
+// Divide uma linha CSV em campos sem copiar (os ponteiros apontam para a linha)
+void splitFields(char* line, std::vector<char*>& fields) {
+  fields.clear();
+  fields.push_back(line);
+  for (char* p = line; *p != '\0'; ++p) {
+    if (*p == ',') {
+      *p = '\0';
+      fields.push_back(p + 1);
+    } else if (*p == '\r') {
+      *p = '\0';
+      break;
+    }
+  }
+}
+
+ParsedFile parseFile(const fs::path& path, int label, int group) {
+  ParsedFile out;
+
+  std::ifstream in(path, std::ios::binary);
+  std::string content(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>()
+  );
+  out.bytes = content.size();
+
+  std::vector<size_t> columns(ADC_DATA_POINTS);
+  std::vector<char*> fields;
+  bool firstLine = true;
+
+  // Garante que a última linha também termine em '\n'
+  if (!content.empty() && content.back() != '\n') {
+    content.push_back('\n');
+  }
+
+  size_t pos = 0;
+  while (pos < content.size()) {
+    size_t end = content.find('\n', pos);
+    content[end] = '\0';
+    char* line = &content[pos];
+    pos = end + 1;
+
+    splitFields(line, fields);
+    if (fields.size() == 1 && fields[0][0] == '\0') {
+      continue;
+    }
+
+    if (firstLine) {
+      firstLine = false;
+      if (std::string(fields[0]) == "Timestamp") {
+        for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+          std::string name = meanColumnName(i);
+          size_t c = 0;
+          while (c < fields.size() && name != fields[c]) {
+            ++c;
+          }
+          if (c == fields.size()) {
+            out.skipped = true;
+            out.reason = "missing column " + name;
+            return out;
+          }
+          columns[i] = c;
+        }
+        continue;
+      }
+      if (fields.size() <= HEADERLESS_TRAILING_COLUMNS) {
+        out.skipped = true;
+        out.reason = "no header and too few columns";
+        return out;
+      }
+      size_t firstMean = fields.size() - HEADERLESS_TRAILING_COLUMNS;
+      for (int i = 0; i < ADC_DATA_POINTS; ++i) {
+        columns[i] = firstMean + i;
+      }
+    }
+
+    Sample sample;
+    sample.label = label;
+    sample.group = group;
+    bool valid = true;
+    for (int i = 0; i < ADC_DATA_POINTS && valid; ++i) {
+      if (columns[i] >= fields.size()) {
+        valid = false;
+        break;
+      }
+      char* endPtr = nullptr;
+      sample.features[i] = std::strtof(fields[columns[i]], &endPtr);
+      valid = endPtr != fields[columns[i]];
+    }
+    if (valid) {
+      out.samples.push_back(sample);
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+Dataset loadDataset(
+    const std::vector<std::string>& directories, unsigned threads
+) {
+  std::vector<fs::path> paths;
+  std::vector<int> labels;
+  for (const std::string& dir : directories) {
+    std::vector<fs::path> found;
+    for (const fs::directory_entry& entry : fs::directory_iterator(dir)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+        found.push_back(entry.path());
+      }
+    }
+    std::sort(found.begin(), found.end());
+    for (const fs::path& path : found) {
+      int label = labelFromFileName(path.stem().string());
+      if (label < 0) {
+        std::fprintf(
+            stderr, "WARN: skipping %s (unknown label)\n", path.c_str()
+        );
+        continue;
+      }
+      paths.push_back(path);
+      labels.push_back(label);
+    }
+  }
+
+  std::vector<ParsedFile> parsed(paths.size());
+  parallelFor(paths.size(), threads, [&](size_t i) {
+    parsed[i] = parseFile(paths[i], labels[i], static_cast<int>(i));
+  });
+
+  Dataset dataset;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    dataset.files.push_back(paths[i].string());
+    dataset.bytesRead += parsed[i].bytes;
+    if (parsed[i].skipped) {
+      std::fprintf(
+          stderr,
+          "WARN: skipping %s (%s)\n",
+          paths[i].c_str(),
+          parsed[i].reason.c_str()
+      );
+      continue;
+    }
+    dataset.samples.insert(
+        dataset.samples.end(),
+        parsed[i].samples.begin(),
+        parsed[i].samples.end()
+    );
+  }
+  return dataset;
+}
@@ -0,0 +1,50 @@
+#ifndef TRAINER_DATASET_H
+#define TRAINER_DATASET_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "SensorData.h"
+
+/**
+ * @brief Class labels, derived from the CSV file name prefix.
+ * The index of each name is the label sent by the firmware.
+ */
+const std::vector<std::string> CLASS_NAMES = {"empty", "negative", "positive"};
+
+/**
+ * @struct Sample
+ * @brief One labeled measurement cycle (one CSV row).
+ */
+struct Sample {
+  std::array<float, ADC_DATA_POINTS> features;  // adc_mean, na ordem do pacote
+  int label;
+  int group;  // Índice do arquivo de origem (para validação cruzada)
+};
+
+/**
+ * @struct Dataset
+ * @brief All samples loaded from a set of recording directories.
+ */
+struct Dataset {
+  std::vector<Sample> samples;
+  std::vector<std::string> files;  // Indexado por Sample::group
+  size_t bytesRead = 0;
+};
+
+/**
+ * @brief Loads every labeled CSV found in the given directories.
+ *
+ * Files whose name does not start with one of CLASS_NAMES, or that lack any
+ * of the `Ch{n}_F{f}Hz_Mean` columns of the current scan shape, are skipped
+ * with a warning. Files without a header row are assumed to follow the
+ * column order written by e-nose_client.py.
+ *
+ * @param directories Directories to scan (not recursive).
+ * @param threads Number of files parsed concurrently.
+ * @return The loaded dataset.
+ */
+Dataset loadDataset(const std::vector<std::string>& directories, unsigned threads);
+
+#endif  // TRAINER_DATASET_H
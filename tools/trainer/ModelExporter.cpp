@@ -0,0 +1,111 @@
+#include "ModelExporter.h"
+
+#include <cstdio>
+
+namespace {
+
+void writeFloatRows(FILE* f, const float* values, int count, const char* indent) {
+  for (int i = 0; i < count; i += 4) {
+    std::fprintf(f, "%s", indent);
+    for (int j = i; j < i + 4 && j < count; ++j) {
+      std::fprintf(f, "%s%.8ef,", j == i ? "" : " ", values[j]);
+    }
+    std::fprintf(f, "\n");
+  }
+}
+
+}  // namespace
+
+bool writeModelHeader(
+    const SoftmaxModel& model,
+    const std::vector<size_t>& classCounts,
+    double cvAccuracy,
+    bool enabled,
+    const std::string& path
+) {
+  FILE* f = std::fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+
+  const int numFeatures = SoftmaxModel::NUM_FEATURES;
+  const int numClasses = model.numClasses();
+
+  std::fprintf(f, "#ifndef ODOR_MODEL_H\n#define ODOR_MODEL_H\n\n");
+  std::fprintf(f, "/**\n * @file OdorModel.h\n");
+  std::fprintf(f, " * @brief Parameters of the on-device odor classifier.\n *\n");
+  std::fprintf(f, " * ARQUIVO GERADO por tools/trainer - não editar manualmente.\n");
+  std::fprintf(
+      f, " * Modelo: regressão softmax sobre adc_mean normalizado (z-score).\n"
+  );
+  std::fprintf(f, " * Amostras de treino:");
+  for (int c = 0; c < numClasses; ++c) {
+    std::fprintf(
+        f,
+        "%s %s=%zu",
+        c == 0 ? "" : ",",
+        CLASS_NAMES[c].c_str(),
+        classCounts[c]
+    );
+  }
+  std::fprintf(f, ".\n");
+  std::fprintf(
+      f,
+      " * Acurácia balanceada (validação cruzada por arquivo): %.3f.\n",
+      cvAccuracy
+  );
+  if (!enabled) {
+    std::fprintf(
+        f,
+        " * DESATIVADO: acurácia abaixo do mínimo do treinador; o firmware "
+        "não\n * classifica até que um modelo aprovado seja exportado.\n"
+    );
+  }
+  std::fprintf(f, " */\n\n");
+
+  std::fprintf(f, "#include \"SensorData.h\"\n\nnamespace OdorModel {\n\n");
+  std::fprintf(
+      f, "constexpr bool ENABLED = %s;\n", enabled ? "true" : "false"
+  );
+  std::fprintf(f, "constexpr int NUM_FEATURES = %d;\n", numFeatures);
+  std::fprintf(f, "constexpr int NUM_CLASSES = %d;\n\n", numClasses);
+  std::fprintf(
+      f,
+      "static_assert(\n    NUM_FEATURES == ADC_DATA_POINTS,\n"
+      "    \"OdorModel was trained for a different scan shape; regenerate "
+      "it.\"\n);\n\n"
+  );
+
+  std::fprintf(f, "constexpr const char* CLASS_NAMES[NUM_CLASSES] = {");
+  for (int c = 0; c < numClasses; ++c) {
+    std::fprintf(f, "%s\"%s\"", c == 0 ? "" : ", ", CLASS_NAMES[c].c_str());
+  }
+  std::fprintf(f, "};\n\n");
+
+  std::fprintf(f, "alignas(16) constexpr float FEATURE_MEAN[NUM_FEATURES] = {\n");
+  writeFloatRows(f, model.featureMean.data(), numFeatures, "    ");
+  std::fprintf(f, "};\n\n");
+
+  std::fprintf(
+      f, "alignas(16) constexpr float FEATURE_INV_STD[NUM_FEATURES] = {\n"
+  );
+  writeFloatRows(f, model.featureInvStd.data(), numFeatures, "    ");
+  std::fprintf(f, "};\n\n");
+
+  std::fprintf(
+      f, "alignas(16) constexpr float WEIGHTS[NUM_CLASSES][NUM_FEATURES] = {\n"
+  );
+  for (int c = 0; c < numClasses; ++c) {
+    std::fprintf(f, "    {\n");
+    writeFloatRows(f, model.weights[c].data(), numFeatures, "        ");
+    std::fprintf(f, "    },\n");
+  }
+  std::fprintf(f, "};\n\n");
+
+  std::fprintf(f, "constexpr float BIAS[NUM_CLASSES] = {\n");
+  writeFloatRows(f, model.bias.data(), numClasses, "    ");
+  std::fprintf(f, "};\n\n");
+
+  std::fprintf(f, "}  // namespace OdorModel\n\n#endif  // ODOR_MODEL_H\n");
+  return std::fclose(f) == 0;
+}
@@ -0,0 +1,28 @@
+#ifndef TRAINER_MODEL_EXPORTER_H
+#define TRAINER_MODEL_EXPORTER_H
+
+#include <string>
+#include <vector>
+
+#include "SoftmaxModel.h"
+
+/**
+ * @brief Writes a trained model as the constexpr header used by the firmware.
+ *
+ * @param model The trained model.
+ * @param classCounts Number of training samples per class (documentation).
+ * @param cvAccuracy Cross-validated balanced accuracy (documentation).
+ * @param enabled false to export a model the firmware must not run, e.g.
+ * one below the minimum cross-validated accuracy.
+ * @param path Destination, normally lib/OdorClassifier/OdorModel.h.
+ * @return true if the file was written.
+ */
+bool writeModelHeader(
+    const SoftmaxModel& model,
+    const std::vector<size_t>& classCounts,
+    double cvAccuracy,
+    bool enabled,
+    const std::string& path
+);
+
+#endif  // TRAINER_MODEL_EXPORTER_H
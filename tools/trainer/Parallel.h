@@ -0,0 +1,36 @@
+#ifndef TRAINER_PARALLEL_H
+#define TRAINER_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs fn(i) for every i in [0, count) on up to `threads` workers.
+ *
+ * Work items are handed out through an atomic counter, so uneven items (a
+ * big CSV next to a small one) still keep every core busy.
+ */
+template <typename Fn>
+void parallelFor(size_t count, unsigned threads, Fn fn) {
+  threads = std::max(1u, std::min<unsigned>(threads, count));
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++) {
+      fn(i);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& th : pool) {
+    th.join();
+  }
+}
+
+#endif  // TRAINER_PARALLEL_H
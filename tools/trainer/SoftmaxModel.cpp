@@ -0,0 +1,144 @@
+#include "SoftmaxModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SoftmaxModel::train(
+    const std::vector<Sample>& samples,
+    const std::vector<size_t>& indices,
+    const TrainingParams& params
+) {
+  const int numClasses = static_cast<int>(CLASS_NAMES.size());
+  const size_t n = indices.size();
+
+  // 1. Estatísticas de normalização (apenas no subconjunto de treino)
+  std::array<double, NUM_FEATURES> sum{};
+  std::array<double, NUM_FEATURES> sumSq{};
+  std::vector<size_t> classCount(numClasses, 0);
+  for (size_t idx : indices) {
+    const Sample& s = samples[idx];
+    for (int i = 0; i < NUM_FEATURES; ++i) {
+      sum[i] += s.features[i];
+      sumSq[i] += double(s.features[i]) * s.features[i];
+    }
+    classCount[s.label]++;
+  }
+  for (int i = 0; i < NUM_FEATURES; ++i) {
+    double mean = sum[i] / n;
+    double var = n > 1 ? (sumSq[i] - n * mean * mean) / (n - 1) : 0.0;
+    featureMean[i] = static_cast<float>(mean);
+    featureInvStd[i] = var > 1e-12 ? static_cast<float>(1.0 / std::sqrt(var))
+                                   : 1.0f;
+  }
+
+  std::vector<float> classWeight(numClasses, 0.0f);
+  for (int c = 0; c < numClasses; ++c) {
+    if (classCount[c] > 0) {
+      classWeight[c] = float(n) / (numClasses * classCount[c]);
+    }
+  }
+
+  // 2. Pré-normaliza uma vez; as épocas só fazem produtos escalares
+  std::vector<std::array<float, NUM_FEATURES>> z(n);
+  for (size_t k = 0; k < n; ++k) {
+    const Sample& s = samples[indices[k]];
+    for (int i = 0; i < NUM_FEATURES; ++i) {
+      z[k][i] = (s.features[i] - featureMean[i]) * featureInvStd[i];
+    }
+  }
+
+  weights.assign(numClasses, std::array<float, NUM_FEATURES>{});
+  bias.assign(numClasses, 0.0f);
+
+  std::vector<std::array<double, NUM_FEATURES>> gradW(numClasses);
+  std::vector<double> gradB(numClasses);
+  std::vector<float> scores(numClasses);
+
+  double totalWeight = 0.0;
+  for (size_t idx : indices) {
+    totalWeight += classWeight[samples[idx].label];
+  }
+
+  // 3. Gradiente descendente em lote completo
+  for (int epoch = 0; epoch < params.epochs; ++epoch) {
+    for (int c = 0; c < numClasses; ++c) {
+      gradW[c].fill(0.0);
+      gradB[c] = 0.0;
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      int label = samples[indices[k]].label;
+      float maxScore = -INFINITY;
+      for (int c = 0; c < numClasses; ++c) {
+        float acc = bias[c];
+        for (int i = 0; i < NUM_FEATURES; ++i) {
+          acc += weights[c][i] * z[k][i];
+        }
+        scores[c] = acc;
+        maxScore = std::max(maxScore, acc);
+      }
+      float sumExp = 0.0f;
+      for (int c = 0; c < numClasses; ++c) {
+        scores[c] = std::exp(scores[c] - maxScore);
+        sumExp += scores[c];
+      }
+      for (int c = 0; c < numClasses; ++c) {
+        double g = classWeight[label] *
+                   (scores[c] / sumExp - (c == label ? 1.0 : 0.0));
+        gradB[c] += g;
+        for (int i = 0; i < NUM_FEATURES; ++i) {
+          gradW[c][i] += g * z[k][i];
+        }
+      }
+    }
+
+    for (int c = 0; c < numClasses; ++c) {
+      bias[c] -= params.learningRate * gradB[c] / totalWeight;
+      for (int i = 0; i < NUM_FEATURES; ++i) {
+        weights[c][i] -= params.learningRate *
+                         (gradW[c][i] / totalWeight + params.l2 * weights[c][i]);
+      }
+    }
+  }
+}
+
+int SoftmaxModel::predict(const std::array<float, NUM_FEATURES>& features
+) const {
+  int best = 0;
+  float bestScore = -INFINITY;
+  for (int c = 0; c < numClasses(); ++c) {
+    float acc = bias[c];
+    for (int i = 0; i < NUM_FEATURES; ++i) {
+      acc += weights[c][i] * (features[i] - featureMean[i]) * featureInvStd[i];
+    }
+    if (acc > bestScore) {
+      bestScore = acc;
+      best = c;
+    }
+  }
+  return best;
+}
+
+double SoftmaxModel::balancedAccuracy(
+    const std::vector<Sample>& samples, const std::vector<size_t>& indices
+) const {
+  std::vector<size_t> total(numClasses(), 0);
+  std::vector<size_t> correct(numClasses(), 0);
+  for (size_t idx : indices) {
+    const Sample& s = samples[idx];
+    total[s.label]++;
+    if (predict(s.features) == s.label) {
+      correct[s.label]++;
+    }
+  }
+
+  double sumRecall = 0.0;
+  int present = 0;
+  for (int c = 0; c < numClasses(); ++c) {
+    if (total[c] > 0) {
+      sumRecall += double(correct[c]) / total[c];
+      present++;
+    }
+  }
+  return present > 0 ? sumRecall / present : 0.0;
+}
@@ -0,0 +1,70 @@
+#ifndef TRAINER_SOFTMAX_MODEL_H
+#define TRAINER_SOFTMAX_MODEL_H
+
+#include <array>
+#include <vector>
+
+#include "Dataset.h"
+
+/**
+ * @struct TrainingParams
+ * @brief Hyperparameters of the softmax-regression trainer.
+ */
+struct TrainingParams {
+  int epochs = 1000;
+  float learningRate = 0.5f;
+  float l2 = 1e-3f;
+};
+
+/**
+ * @class SoftmaxModel
+ * @brief Multiclass linear model with z-score input normalization.
+ *
+ * This is the exact model evaluated by OdorClassifier on the device, so a
+ * trained instance can be exported as OdorModel.h without conversion.
+ */
+class SoftmaxModel {
+ public:
+  static constexpr int NUM_FEATURES = ADC_DATA_POINTS;
+
+  /**
+   * @brief Fits the model by full-batch gradient descent.
+   *
+   * Normalization statistics are computed on the training subset only, and
+   * each class is weighted by the inverse of its frequency so that the
+   * small "empty" class is not ignored.
+   *
+   * @param samples All available samples.
+   * @param indices The subset of samples to train on.
+   * @param params The training hyperparameters.
+   */
+  void train(
+      const std::vector<Sample>& samples,
+      const std::vector<size_t>& indices,
+      const TrainingParams& params
+  );
+
+  /**
+   * @brief Predicts the class of a feature vector.
+   * @param features The raw (not normalized) adc_mean values.
+   * @return The predicted label.
+   */
+  int predict(const std::array<float, NUM_FEATURES>& features) const;
+
+  /**
+   * @brief Computes the class-balanced accuracy over a subset of samples.
+   * @return The mean of per-class recalls, in [0, 1].
+   */
+  double balancedAccuracy(
+      const std::vector<Sample>& samples, const std::vector<size_t>& indices
+  ) const;
+
+  int numClasses() const { return static_cast<int>(bias.size()); }
+
+  std::array<float, NUM_FEATURES> featureMean{};
+  std::array<float, NUM_FEATURES> featureInvStd{};
+  std::vector<std::array<float, NUM_FEATURES>> weights;
+  std::vector<float> bias;
+};
+
+#endif  // TRAINER_SOFTMAX_MODEL_H
@@ -0,0 +1,250 @@
+/**
+ * @file main.cpp
+ * @brief Host-side trainer for the on-device odor classifier.
+ *
+ * Loads every labeled CSV recorded by e-nose_client.py, runs a grouped
+ * k-fold cross-validation (one fold never shares a recording session with
+ * another) over a small grid of regularization strengths in parallel,
+ * retrains the best configuration on all data and exports it as
+ * lib/OdorClassifier/OdorModel.h. A model whose cross-validated balanced
+ * accuracy is below --min-accuracy is not exported and the trainer exits
+ * with 1; --export-disabled writes it anyway with OdorModel::ENABLED set to
+ * false, so the firmware does not classify with it.
+ *
+ * Build and run from the repository root:
+ *   pio run -e trainer
+ *   .pio/build/trainer/program --data data --data data_old
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Dataset.h"
+#include "ModelExporter.h"
+#include "Parallel.h"
+#include "SoftmaxModel.h"
+
+namespace {
+
+const float L2_GRID[] = {1e-4f, 1e-3f, 1e-2f, 1e-1f};
+const int L2_GRID_SIZE = sizeof(L2_GRID) / sizeof(L2_GRID[0]);
+
+// Acurácia balanceada mínima para exportar (o acaso com 3 classes é 0.33)
+const double MIN_CV_BALANCED_ACCURACY = 0.6;
+
+struct Options {
+  std::vector<std::string> dataDirs;
+  std::string output = "lib/OdorClassifier/OdorModel.h";
+  int folds = 5;
+  int epochs = 1000;
+  unsigned threads = std::thread::hardware_concurrency();
+  double minAccuracy = MIN_CV_BALANCED_ACCURACY;
+  bool exportModel = true;
+  bool exportDisabled = false;
+};
+
+void printUsage(const char* argv0) {
+  std::fprintf(
+      stderr,
+      "Usage: %s [--data DIR]... [--out FILE] [--folds K] [--epochs N]\n"
+      "          [--threads N] [--min-accuracy A] [--no-export]\n"
+      "          [--export-disabled]\n"
+      "Defaults: --data data --data data_old --out %s --min-accuracy %.2f\n",
+      argv0,
+      Options().output.c_str(),
+      MIN_CV_BALANCED_ACCURACY
+  );
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--data" && hasValue) {
+      opts.dataDirs.push_back(argv[++i]);
+    } else if (arg == "--out" && hasValue) {
+      opts.output = argv[++i];
+    } else if (arg == "--folds" && hasValue) {
+      opts.folds = std::atoi(argv[++i]);
+    } else if (arg == "--epochs" && hasValue) {
+      opts.epochs = std::atoi(argv[++i]);
+    } else if (arg == "--threads" && hasValue) {
+      opts.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (arg == "--min-accuracy" && hasValue) {
+      opts.minAccuracy = std::atof(argv[++i]);
+    } else if (arg == "--no-export") {
+      opts.exportModel = false;
+    } else if (arg == "--export-disabled") {
+      opts.exportDisabled = true;
+    } else {
+      return false;
+    }
+  }
+  if (opts.dataDirs.empty()) {
+    opts.dataDirs = {"data", "data_old"};
+  }
+  if (opts.threads == 0) {
+    opts.threads = 1;
+  }
+  return opts.folds >= 2 && opts.epochs > 0;
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start
+  )
+      .count();
+}
+
+// Distribui os arquivos de cada classe entre os folds (round-robin), para
+// que nenhum fold de teste compartilhe uma sessão de gravação com o treino
+std::vector<int> assignFolds(const Dataset& dataset, int folds) {
+  std::vector<int> groupLabel(dataset.files.size(), -1);
+  for (const Sample& s : dataset.samples) {
+    groupLabel[s.group] = s.label;
+  }
+
+  std::vector<int> groupFold(dataset.files.size(), 0);
+  std::vector<int> nextFold(CLASS_NAMES.size(), 0);
+  for (size_t g = 0; g < groupLabel.size(); ++g) {
+    if (groupLabel[g] >= 0) {
+      groupFold[g] = nextFold[groupLabel[g]]++ % folds;
+    }
+  }
+  return groupFold;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // 1. Leitura dos CSVs em paralelo
+  auto start = std::chrono::steady_clock::now();
+  Dataset dataset = loadDataset(opts.dataDirs, opts.threads);
+  double parseMs = msSince(start);
+  if (dataset.samples.empty()) {
+    std::fprintf(stderr, "ERROR: no labeled samples found.\n");
+    return 1;
+  }
+
+  std::vector<size_t> classCounts(CLASS_NAMES.size(), 0);
+  for (const Sample& s : dataset.samples) {
+    classCounts[s.label]++;
+  }
+  std::printf(
+      "Loaded %zu samples from %zu files (%.1f MB) in %.1f ms (%.1f MB/s)\n",
+      dataset.samples.size(),
+      dataset.files.size(),
+      dataset.bytesRead / 1e6,
+      parseMs,
+      dataset.bytesRead / 1e3 / parseMs
+  );
+  for (size_t c = 0; c < CLASS_NAMES.size(); ++c) {
+    std::printf("  %-10s %zu\n", CLASS_NAMES[c].c_str(), classCounts[c]);
+  }
+
+  // 2. Validação cruzada: cada (l2, fold) é uma tarefa independente
+  std::vector<int> groupFold = assignFolds(dataset, opts.folds);
+  std::vector<std::vector<size_t>> trainIdx(opts.folds);
+  std::vector<std::vector<size_t>> testIdx(opts.folds);
+  for (size_t i = 0; i < dataset.samples.size(); ++i) {
+    int fold = groupFold[dataset.samples[i].group];
+    for (int f = 0; f < opts.folds; ++f) {
+      (f == fold ? testIdx : trainIdx)[f].push_back(i);
+    }
+  }
+
+  const size_t numTasks = size_t(L2_GRID_SIZE) * opts.folds;
+  std::vector<double> taskAccuracy(numTasks, 0.0);
+  start = std::chrono::steady_clock::now();
+  parallelFor(numTasks, opts.threads, [&](size_t task) {
+    int grid = static_cast<int>(task / opts.folds);
+    int fold = static_cast<int>(task % opts.folds);
+    if (testIdx[fold].empty() || trainIdx[fold].empty()) {
+      return;
+    }
+    TrainingParams params;
+    params.epochs = opts.epochs;
+    params.l2 = L2_GRID[grid];
+    SoftmaxModel model;
+    model.train(dataset.samples, trainIdx[fold], params);
+    taskAccuracy[task] = model.balancedAccuracy(dataset.samples, testIdx[fold]);
+  });
+  double cvMs = msSince(start);
+
+  int bestGrid = 0;
+  double bestAccuracy = -1.0;
+  for (int g = 0; g < L2_GRID_SIZE; ++g) {
+    double sum = 0.0;
+    int used = 0;
+    for (int f = 0; f < opts.folds; ++f) {
+      if (!testIdx[f].empty()) {
+        sum += taskAccuracy[size_t(g) * opts.folds + f];
+        used++;
+      }
+    }
+    double accuracy = used > 0 ? sum / used : 0.0;
+    std::printf("  l2=%-8g balanced accuracy %.3f\n", L2_GRID[g], accuracy);
+    if (accuracy > bestAccuracy) {
+      bestAccuracy = accuracy;
+      bestGrid = g;
+    }
+  }
+  std::printf(
+      "Cross-validation: %zu trainings on %u threads in %.1f ms\n",
+      numTasks,
+      opts.threads,
+      cvMs
+  );
+
+  // 3. Treino final com todos os dados e exportação do header
+  std::vector<size_t> all(dataset.samples.size());
+  for (size_t i = 0; i < all.size(); ++i) {
+    all[i] = i;
+  }
+  TrainingParams params;
+  params.epochs = opts.epochs;
+  params.l2 = L2_GRID[bestGrid];
+  start = std::chrono::steady_clock::now();
+  SoftmaxModel model;
+  model.train(dataset.samples, all, params);
+  std::printf(
+      "Final model (l2=%g) trained in %.1f ms\n", params.l2, msSince(start)
+  );
+
+  // 4. Modelo abaixo do mínimo não vai para o firmware como ativo
+  bool passed = bestAccuracy >= opts.minAccuracy;
+  if (!passed) {
+    std::fprintf(
+        stderr,
+        "ERROR: balanced accuracy %.3f is below the minimum %.3f\n",
+        bestAccuracy,
+        opts.minAccuracy
+    );
+  }
+
+  if (opts.exportModel && (passed || opts.exportDisabled)) {
+    if (!writeModelHeader(
+            model, classCounts, bestAccuracy, passed, opts.output
+        )) {
+      std::fprintf(stderr, "ERROR: could not write %s\n", opts.output.c_str());
+      return 1;
+    }
+    std::printf(
+        "Model written to %s%s\n",
+        opts.output.c_str(),
+        passed ? "" : " (disabled)"
+    );
+  }
+  return passed ? 0 : 1;
+}